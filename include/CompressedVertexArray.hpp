@@ -0,0 +1,497 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+    class CompressedVertexArray
+    class CompressedVertexArray_iterator
+
+    This file defines a read-only vertex container taking 8 bytes per
+    vertex instead of the 20 bytes of `sf::Vertex`, for static geometry:
+
+        positions           16-bit fractions of the bounding box
+        colors              16-bit indices in a color palette
+        texture coordinates 16-bit indices in a texture coordinates palette
+
+    Colors and texture coordinates round-trip exactly, positions within
+    half a 16-bit step of the bounding box. An array with more than 65536
+    distinct colors or texture coordinates cannot be encoded.
+
+    The iterators decode vertices by batches into a buffer they own, with
+    SSE2 when available, and yield `sf::Vertex` by value.
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include "VertexArray_iterator.hpp"
+#include "VertexArray_quantize.hpp"
+#include "VertexArray_reduce.hpp"
+#include "VertexArray_transform.hpp"
+
+class CompressedVertexArray_iterator;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class CompressedVertexArray
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+class CompressedVertexArray
+{
+public:
+    using value_type        = sf::Vertex;
+    using size_type         = std::size_t;
+    using const_iterator    = CompressedVertexArray_iterator;
+
+private:
+    std::vector<std::uint16_t>  m_positions;        // x, y per vertex
+    std::vector<std::uint16_t>  m_colors;
+    std::vector<std::uint16_t>  m_tex_coords;
+    std::vector<sf::Color>      m_color_palette;
+    std::vector<sf::Vector2f>   m_tex_palette;
+
+    sf::Vector2f                m_origin;
+    sf::Vector2f                m_step;
+    sf::PrimitiveType           m_primitive_type = sf::Points;
+
+public:
+    CompressedVertexArray() = default;
+
+    //* @return false if `va` holds more than 65536 distinct colors or texture coordinates
+    bool                    encode(sf::VertexArray const& va);
+
+    // Replace the vertices and primitive type of `va` by the decoded ones
+    void                    decode(sf::VertexArray& va) const;
+
+    // Decode vertices [first, first + count) to `out`
+    void                    decode(std::size_t first, std::size_t count, sf::Vertex* out) const noexcept;
+
+    void                    clear() noexcept;
+
+    sf::PrimitiveType       getPrimitiveType() const noexcept;
+    std::size_t             getVertexCount() const noexcept;
+    bool                    empty() const noexcept;
+
+    // Bytes held by the vertices and the palettes
+    std::size_t             memory_size() const noexcept;
+
+    sf::Vertex              operator[](std::size_t) const noexcept;
+
+    const_iterator          begin() const noexcept;
+    const_iterator          end() const noexcept;
+    const_iterator          cbegin() const noexcept;
+    const_iterator          cend() const noexcept;
+
+};
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class CompressedVertexArray_iterator
+    random-access iterator decoding `batch_size` vertices at a time.
+
+    Copies of an iterator share no state: each one decodes its own batch.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+class CompressedVertexArray_iterator
+{
+public:
+    using value_type        = sf::Vertex;
+    using difference_type   = std::ptrdiff_t;
+    using reference         = sf::Vertex;
+    using pointer           = void;
+    using iterator_category = std::input_iterator_tag;
+#if __cplusplus > 201703L
+    using iterator_concept  = std::random_access_iterator_tag;
+#endif
+
+    static constexpr std::size_t batch_size = 8;
+
+private:
+    static constexpr std::size_t no_batch = static_cast<std::size_t>(-1);
+
+    CompressedVertexArray const*                    m_array = nullptr;
+    std::size_t                                     m_index = 0;
+    mutable std::size_t                             m_batch = no_batch;
+    mutable std::array<sf::Vertex, batch_size>      m_decoded;
+
+public:
+    CompressedVertexArray_iterator() noexcept = default;
+
+    CompressedVertexArray_iterator(CompressedVertexArray const* array, std::size_t idx) noexcept
+        : m_array   {array}
+        , m_index   {idx}
+    {}
+
+    reference operator*() const noexcept {
+        return decoded(m_index);
+    }
+
+    reference operator[](difference_type n) const noexcept {
+        return decoded(m_index + n);
+    }
+
+    CompressedVertexArray_iterator& operator++() noexcept { ++m_index; return *this; }
+    CompressedVertexArray_iterator& operator--() noexcept { --m_index; return *this; }
+    CompressedVertexArray_iterator  operator++(int) noexcept { auto copy = *this; ++m_index; return copy; }
+    CompressedVertexArray_iterator  operator--(int) noexcept { auto copy = *this; --m_index; return copy; }
+    CompressedVertexArray_iterator& operator+=(difference_type n) noexcept { m_index += n; return *this; }
+    CompressedVertexArray_iterator& operator-=(difference_type n) noexcept { m_index -= n; return *this; }
+
+    friend CompressedVertexArray_iterator operator+(CompressedVertexArray_iterator it, difference_type n) noexcept
+    {
+        return it += n;
+    }
+
+    friend CompressedVertexArray_iterator operator+(difference_type n, CompressedVertexArray_iterator it) noexcept
+    {
+        return it += n;
+    }
+
+    friend CompressedVertexArray_iterator operator-(CompressedVertexArray_iterator it, difference_type n) noexcept
+    {
+        return it -= n;
+    }
+
+    friend difference_type operator-(CompressedVertexArray_iterator const& lhs, CompressedVertexArray_iterator const& rhs) noexcept
+    {
+        return static_cast<difference_type>(lhs.m_index)
+             - static_cast<difference_type>(rhs.m_index);
+    }
+
+    friend bool operator==(CompressedVertexArray_iterator const& lhs, CompressedVertexArray_iterator const& rhs) noexcept
+    {
+        return lhs.m_array == rhs.m_array
+            && lhs.m_index == rhs.m_index;
+    }
+
+    friend bool operator!=(CompressedVertexArray_iterator const& lhs, CompressedVertexArray_iterator const& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    friend bool operator<(CompressedVertexArray_iterator const& lhs, CompressedVertexArray_iterator const& rhs) noexcept
+    {
+        return lhs.m_index < rhs.m_index;
+    }
+
+    friend bool operator>(CompressedVertexArray_iterator const& lhs, CompressedVertexArray_iterator const& rhs) noexcept
+    {
+        return lhs.m_index > rhs.m_index;
+    }
+
+    friend bool operator<=(CompressedVertexArray_iterator const& lhs, CompressedVertexArray_iterator const& rhs) noexcept
+    {
+        return lhs.m_index <= rhs.m_index;
+    }
+
+    friend bool operator>=(CompressedVertexArray_iterator const& lhs, CompressedVertexArray_iterator const& rhs) noexcept
+    {
+        return lhs.m_index >= rhs.m_index;
+    }
+
+private:
+    sf::Vertex decoded(std::size_t index) const noexcept
+    {
+        auto const batch = index - index % batch_size;
+        if (batch != m_batch) {
+            auto const count = std::min(batch_size, m_array->getVertexCount() - batch);
+            m_array->decode(batch, count, m_decoded.data());
+            m_batch = batch;
+        }
+        return m_decoded[index - batch];
+    }
+
+};
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Impl.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace vertex_array::impl
+{
+inline void decode_positions_scalar(
+    std::uint16_t const*    positions,
+    std::size_t             count,
+    sf::Vector2f            origin,
+    sf::Vector2f            step,
+    sf::Vertex*             out
+) noexcept {
+    for (std::size_t i=0; i < count; ++i) {
+        out[i].position = {
+            origin.x + static_cast<float>(positions[2*i]) * step.x,
+            origin.y + static_cast<float>(positions[2*i + 1]) * step.y
+        };
+    }
+}
+
+
+
+#ifdef SF_VA_SIMD_X86
+// Four vertices per iteration: 8 coordinates widened to two float registers
+__attribute__((target("sse2")))
+inline void decode_positions_sse2(
+    std::uint16_t const*    positions,
+    std::size_t             count,
+    sf::Vector2f            origin,
+    sf::Vector2f            step,
+    sf::Vertex*             out
+) noexcept {
+    __m128i const zero = _mm_setzero_si128();
+    __m128 const org = _mm_setr_ps(origin.x, origin.y, origin.x, origin.y);
+    __m128 const stp = _mm_setr_ps(step.x, step.y, step.x, step.y);
+    std::size_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i const q = _mm_loadu_si128(reinterpret_cast<__m128i const*>(positions + 2*i));
+        __m128 const lo = _mm_add_ps(org, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(q, zero)), stp));
+        __m128 const hi = _mm_add_ps(org, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(q, zero)), stp));
+        _mm_storel_pi(reinterpret_cast<__m64*>(vec2_field<position_offset>(out + i)), lo);
+        _mm_storeh_pi(reinterpret_cast<__m64*>(vec2_field<position_offset>(out + i + 1)), lo);
+        _mm_storel_pi(reinterpret_cast<__m64*>(vec2_field<position_offset>(out + i + 2)), hi);
+        _mm_storeh_pi(reinterpret_cast<__m64*>(vec2_field<position_offset>(out + i + 3)), hi);
+    }
+    decode_positions_scalar(positions + 2*i, count - i, origin, step, out + i);
+}
+#endif // SF_VA_SIMD_X86
+
+
+
+inline void decode_positions(
+    std::uint16_t const*    positions,
+    std::size_t             count,
+    sf::Vector2f            origin,
+    sf::Vector2f            step,
+    sf::Vertex*             out
+) noexcept {
+#ifdef SF_VA_SIMD_X86
+    if (runtime_isa() != Isa::scalar) {
+        decode_positions_sse2(positions, count, origin, step, out);
+        return;
+    }
+#endif
+    decode_positions_scalar(positions, count, origin, step, out);
+}
+
+
+
+/**
+ *  Index of each distinct value in a palette, in order of appearance.
+ *  `Key` packs a value into an integer.
+ */
+template <typename Value, typename Key>
+class Palette_builder
+{
+    std::unordered_map<Key, std::uint16_t>  m_indices;
+    std::vector<Value>&                     m_palette;
+
+public:
+    explicit Palette_builder(std::vector<Value>& palette) : m_palette {palette} {}
+
+    //* @return false if the palette is full
+    bool index(Key key, Value const& value, std::uint16_t& out)
+    {
+        auto const [it, inserted] = m_indices.try_emplace(key, static_cast<std::uint16_t>(m_palette.size()));
+        if (inserted) {
+            if (m_palette.size() > 0xFFFF) {
+                return false;
+            }
+            m_palette.push_back(value);
+        }
+        out = it->second;
+        return true;
+    }
+
+};
+
+
+
+inline std::uint32_t color_key(sf::Color color) noexcept
+{
+    return static_cast<std::uint32_t>(color.r) << 24
+         | static_cast<std::uint32_t>(color.g) << 16
+         | static_cast<std::uint32_t>(color.b) << 8
+         | static_cast<std::uint32_t>(color.a);
+}
+
+
+
+inline std::uint64_t vec2_key(sf::Vector2f v) noexcept
+{
+    std::uint32_t x, y;
+    std::memcpy(&x, &v.x, sizeof x);
+    std::memcpy(&y, &v.y, sizeof y);
+    return static_cast<std::uint64_t>(x) << 32 | y;
+}
+
+
+
+} // namespace vertex_array::impl
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    CompressedVertexArray implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+inline bool CompressedVertexArray::encode(sf::VertexArray const& va)
+{
+    using namespace vertex_array::impl;
+    clear();
+
+    auto const count = va.getVertexCount();
+    auto const bounds = sf::bounds(va);
+
+    m_primitive_type = va.getPrimitiveType();
+    m_origin = {bounds.left, bounds.top};
+    m_step = {quantization_step(bounds.width), quantization_step(bounds.height)};
+
+    m_positions.resize(2 * count);
+    m_colors.resize(count);
+    m_tex_coords.resize(count);
+
+    Palette_builder<sf::Color, std::uint32_t> colors {m_color_palette};
+    Palette_builder<sf::Vector2f, std::uint64_t> tex_coords {m_tex_palette};
+
+    for (std::size_t i=0; i < count; ++i)
+    {
+        auto const& vertex = va[i];
+        m_positions[2*i]     = quantize(vertex.position.x, bounds.left, bounds.width);
+        m_positions[2*i + 1] = quantize(vertex.position.y, bounds.top, bounds.height);
+
+        if (!colors.index(color_key(vertex.color), vertex.color, m_colors[i])
+            || !tex_coords.index(vec2_key(vertex.texCoords), vertex.texCoords, m_tex_coords[i]))
+        {
+            clear();
+            return false;
+        }
+    }
+
+    m_color_palette.shrink_to_fit();
+    m_tex_palette.shrink_to_fit();
+    return true;
+}
+
+
+
+
+inline void CompressedVertexArray::decode(sf::VertexArray& va) const
+{
+    va.setPrimitiveType(m_primitive_type);
+    va.resize(getVertexCount());
+    decode(0, getVertexCount(), sf::contiguous_begin(va));
+}
+
+
+
+
+inline void CompressedVertexArray::decode(std::size_t first, std::size_t count, sf::Vertex* out)
+const noexcept
+{
+    vertex_array::impl::decode_positions(m_positions.data() + 2*first, count, m_origin, m_step, out);
+
+    for (std::size_t i=0; i < count; ++i) {
+        out[i].color = m_color_palette[m_colors[first + i]];
+        out[i].texCoords = m_tex_palette[m_tex_coords[first + i]];
+    }
+}
+
+
+
+
+inline void CompressedVertexArray::clear() noexcept
+{
+    m_positions.clear();
+    m_colors.clear();
+    m_tex_coords.clear();
+    m_color_palette.clear();
+    m_tex_palette.clear();
+    m_origin = {};
+    m_step = {};
+    m_primitive_type = sf::Points;
+}
+
+
+
+
+inline sf::PrimitiveType CompressedVertexArray::getPrimitiveType() const noexcept
+{
+    return m_primitive_type;
+}
+
+
+
+
+inline std::size_t CompressedVertexArray::getVertexCount() const noexcept
+{
+    return m_colors.size();
+}
+
+
+
+
+inline bool CompressedVertexArray::empty() const noexcept
+{
+    return m_colors.empty();
+}
+
+
+
+
+inline std::size_t CompressedVertexArray::memory_size() const noexcept
+{
+    return m_positions.size() * sizeof(std::uint16_t)
+         + m_colors.size() * sizeof(std::uint16_t)
+         + m_tex_coords.size() * sizeof(std::uint16_t)
+         + m_color_palette.size() * sizeof(sf::Color)
+         + m_tex_palette.size() * sizeof(sf::Vector2f);
+}
+
+
+
+
+inline sf::Vertex CompressedVertexArray::operator[](std::size_t index) const noexcept
+{
+    sf::Vertex vertex;
+    decode(index, 1, &vertex);
+    return vertex;
+}
+
+
+
+
+inline auto CompressedVertexArray::begin() const noexcept -> const_iterator
+{
+    return {this, 0};
+}
+
+
+
+
+inline auto CompressedVertexArray::end() const noexcept -> const_iterator
+{
+    return {this, getVertexCount()};
+}
+
+
+
+
+inline auto CompressedVertexArray::cbegin() const noexcept -> const_iterator
+{
+    return begin();
+}
+
+
+
+
+inline auto CompressedVertexArray::cend() const noexcept -> const_iterator
+{
+    return end();
+}
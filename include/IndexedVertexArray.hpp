@@ -0,0 +1,428 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+    class IndexedVertexArray
+    class IndexedVertexArray_iterator
+
+    This file defines a vertex container storing each distinct vertex once,
+    plus one index per vertex of the original array. Grids of quads, where
+    neighbour tiles repeat the same corners, shrink to about a vertex per
+    tile plus the indices:
+
+        IndexedVertexArray<std::uint16_t> tiles;
+        tiles.encode(tilemap);
+        sf::apply_transform(tiles.data(), tiles.data() + tiles.unique_count(), camera);
+        tiles.decode(tilemap);
+
+    Vertices are deduplicated by hashing their exact bit patterns, so
+    corners only merge when their colors and texture coordinates match too
+    (a repeated texture, not an atlas). Bulk operations on data() run once
+    per distinct vertex.
+
+    The const iterators have the API of `VertexArray_const_iterator` and
+    expand the indices on the fly.
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include "VertexArray_iterator.hpp"
+
+template <typename Index>
+class IndexedVertexArray_iterator;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class IndexedVertexArray
+
+    @param  Index   std::uint16_t or std::uint32_t
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+template <typename Index = std::uint32_t>
+class IndexedVertexArray
+{
+    static_assert(std::is_same_v<Index, std::uint16_t> || std::is_same_v<Index, std::uint32_t>,
+        "indices are 16 or 32-bit unsigned integers");
+
+public:
+    using value_type        = sf::Vertex;
+    using size_type         = std::size_t;
+    using index_type        = Index;
+    using const_iterator    = IndexedVertexArray_iterator<Index>;
+
+    // Distinct vertices that indices can address
+    static constexpr std::size_t max_unique = std::size_t{std::numeric_limits<Index>::max()} + 1;
+
+private:
+    std::vector<sf::Vertex>     m_vertices;
+    std::vector<Index>          m_indices;
+    sf::PrimitiveType           m_primitive_type = sf::Points;
+
+public:
+    IndexedVertexArray() = default;
+
+    //* @return false if `va` holds more than `max_unique` distinct vertices
+    bool                    encode(sf::VertexArray const& va);
+
+    // Replace the vertices and primitive type of `va` by the expanded ones
+    void                    decode(sf::VertexArray& va) const;
+
+    void                    clear() noexcept;
+
+    sf::PrimitiveType       getPrimitiveType() const noexcept;
+
+    // Vertices of the expanded array
+    std::size_t             getVertexCount() const noexcept;
+    bool                    empty() const noexcept;
+
+    // The distinct vertices, to be modified in place once each
+    std::size_t             unique_count() const noexcept;
+    sf::Vertex*             data() noexcept;
+    sf::Vertex const*       data() const noexcept;
+
+    // One index in data() per vertex of the expanded array
+    Index const*            indices() const noexcept;
+
+    // Bytes held by the vertices and the indices
+    std::size_t             memory_size() const noexcept;
+
+    sf::Vertex const&       operator[](std::size_t) const noexcept;
+
+    const_iterator          begin() const noexcept;
+    const_iterator          end() const noexcept;
+    const_iterator          cbegin() const noexcept;
+    const_iterator          cend() const noexcept;
+
+};
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class IndexedVertexArray_iterator
+    random-access iterator over the expanded vertices.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+template <typename Index>
+class IndexedVertexArray_iterator
+{
+public:
+    using value_type        = sf::Vertex;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = sf::Vertex const*;
+    using reference         = sf::Vertex const&;
+    using iterator_category = std::random_access_iterator_tag;
+
+private:
+    IndexedVertexArray<Index> const*    m_array = nullptr;
+    std::size_t                         m_index = 0;
+
+public:
+    IndexedVertexArray_iterator() noexcept = default;
+
+    IndexedVertexArray_iterator(IndexedVertexArray<Index> const& array, std::size_t idx) noexcept
+        : m_array   {&array}
+        , m_index   {idx}
+    {}
+
+    reference operator*() const noexcept { return (*m_array)[m_index]; }
+    pointer operator->() const noexcept { return &(*m_array)[m_index]; }
+    reference operator[](difference_type n) const noexcept { return (*m_array)[m_index + n]; }
+
+    IndexedVertexArray_iterator& operator++() noexcept { ++m_index; return *this; }
+    IndexedVertexArray_iterator& operator--() noexcept { --m_index; return *this; }
+    IndexedVertexArray_iterator  operator++(int) noexcept { auto copy = *this; ++m_index; return copy; }
+    IndexedVertexArray_iterator  operator--(int) noexcept { auto copy = *this; --m_index; return copy; }
+    IndexedVertexArray_iterator& operator+=(difference_type n) noexcept { m_index += n; return *this; }
+    IndexedVertexArray_iterator& operator-=(difference_type n) noexcept { m_index -= n; return *this; }
+
+    friend IndexedVertexArray_iterator operator+(IndexedVertexArray_iterator it, difference_type n) noexcept
+    {
+        return it += n;
+    }
+
+    friend IndexedVertexArray_iterator operator+(difference_type n, IndexedVertexArray_iterator it) noexcept
+    {
+        return it += n;
+    }
+
+    friend IndexedVertexArray_iterator operator-(IndexedVertexArray_iterator it, difference_type n) noexcept
+    {
+        return it -= n;
+    }
+
+    friend difference_type operator-(IndexedVertexArray_iterator const& lhs, IndexedVertexArray_iterator const& rhs) noexcept
+    {
+        return static_cast<difference_type>(lhs.m_index)
+             - static_cast<difference_type>(rhs.m_index);
+    }
+
+    friend bool operator==(IndexedVertexArray_iterator const& lhs, IndexedVertexArray_iterator const& rhs) noexcept
+    {
+        return lhs.m_array == rhs.m_array
+            && lhs.m_index == rhs.m_index;
+    }
+
+    friend bool operator!=(IndexedVertexArray_iterator const& lhs, IndexedVertexArray_iterator const& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    friend bool operator<(IndexedVertexArray_iterator const& lhs, IndexedVertexArray_iterator const& rhs) noexcept
+    {
+        return lhs.m_index < rhs.m_index;
+    }
+
+    friend bool operator>(IndexedVertexArray_iterator const& lhs, IndexedVertexArray_iterator const& rhs) noexcept
+    {
+        return lhs.m_index > rhs.m_index;
+    }
+
+    friend bool operator<=(IndexedVertexArray_iterator const& lhs, IndexedVertexArray_iterator const& rhs) noexcept
+    {
+        return lhs.m_index <= rhs.m_index;
+    }
+
+    friend bool operator>=(IndexedVertexArray_iterator const& lhs, IndexedVertexArray_iterator const& rhs) noexcept
+    {
+        return lhs.m_index >= rhs.m_index;
+    }
+
+};
+
+
+
+
+#if __cplusplus > 201703L
+static_assert(std::random_access_iterator<IndexedVertexArray_iterator<std::uint16_t>>);
+static_assert(std::random_access_iterator<IndexedVertexArray_iterator<std::uint32_t>>);
+#endif
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Impl.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace vertex_array::impl
+{
+//* Bit pattern of a vertex: equal keys are interchangeable vertices
+struct Vertex_key
+{
+    std::uint32_t   bits[5];
+
+    explicit Vertex_key(sf::Vertex const& vertex) noexcept
+    {
+        static_assert(sizeof(bits) == sizeof(sf::Vertex), "unexpected sf::Vertex layout");
+        std::memcpy(bits, &vertex, sizeof bits);
+    }
+
+    friend bool operator==(Vertex_key const& lhs, Vertex_key const& rhs) noexcept
+    {
+        return std::memcmp(lhs.bits, rhs.bits, sizeof lhs.bits) == 0;
+    }
+
+};
+
+
+
+struct Vertex_key_hash
+{
+    std::size_t operator()(Vertex_key const& key) const noexcept
+    {
+        std::uint64_t hash = 0xcbf29ce484222325;    // FNV-1a over 32-bit words
+        for (auto word : key.bits) {
+            hash ^= word;
+            hash *= 0x100000001b3;
+        }
+        return static_cast<std::size_t>(hash ^ (hash >> 32));
+    }
+
+};
+
+} // namespace vertex_array::impl
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    IndexedVertexArray implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+template <typename Index>
+bool IndexedVertexArray<Index>::encode(sf::VertexArray const& va)
+{
+    using namespace vertex_array::impl;
+    clear();
+
+    auto const count = va.getVertexCount();
+    m_primitive_type = va.getPrimitiveType();
+    m_indices.resize(count);
+
+    std::unordered_map<Vertex_key, Index, Vertex_key_hash> unique;
+    unique.reserve(count / 2);
+
+    for (std::size_t i=0; i < count; ++i)
+    {
+        auto const& vertex = va[i];
+        auto const [it, inserted] = unique.try_emplace(Vertex_key{vertex}, static_cast<Index>(m_vertices.size()));
+        if (inserted) {
+            if (m_vertices.size() == max_unique) {
+                clear();
+                return false;
+            }
+            m_vertices.push_back(vertex);
+        }
+        m_indices[i] = it->second;
+    }
+
+    m_vertices.shrink_to_fit();
+    return true;
+}
+
+
+
+
+template <typename Index>
+void IndexedVertexArray<Index>::decode(sf::VertexArray& va) const
+{
+    va.setPrimitiveType(m_primitive_type);
+    va.resize(m_indices.size());
+
+    sf::Vertex* out = sf::contiguous_begin(va);
+    for (std::size_t i=0; i < m_indices.size(); ++i)
+        out[i] = m_vertices[m_indices[i]];
+}
+
+
+
+
+template <typename Index>
+void IndexedVertexArray<Index>::clear() noexcept
+{
+    m_vertices.clear();
+    m_indices.clear();
+    m_primitive_type = sf::Points;
+}
+
+
+
+
+template <typename Index>
+sf::PrimitiveType IndexedVertexArray<Index>::getPrimitiveType() const noexcept
+{
+    return m_primitive_type;
+}
+
+
+
+
+template <typename Index>
+std::size_t IndexedVertexArray<Index>::getVertexCount() const noexcept
+{
+    return m_indices.size();
+}
+
+
+
+
+template <typename Index>
+bool IndexedVertexArray<Index>::empty() const noexcept
+{
+    return m_indices.empty();
+}
+
+
+
+
+template <typename Index>
+std::size_t IndexedVertexArray<Index>::unique_count() const noexcept
+{
+    return m_vertices.size();
+}
+
+
+
+
+template <typename Index>
+sf::Vertex* IndexedVertexArray<Index>::data() noexcept
+{
+    return m_vertices.data();
+}
+
+
+
+
+template <typename Index>
+sf::Vertex const* IndexedVertexArray<Index>::data() const noexcept
+{
+    return m_vertices.data();
+}
+
+
+
+
+template <typename Index>
+Index const* IndexedVertexArray<Index>::indices() const noexcept
+{
+    return m_indices.data();
+}
+
+
+
+
+template <typename Index>
+std::size_t IndexedVertexArray<Index>::memory_size() const noexcept
+{
+    return m_vertices.size() * sizeof(sf::Vertex)
+         + m_indices.size() * sizeof(Index);
+}
+
+
+
+
+template <typename Index>
+sf::Vertex const& IndexedVertexArray<Index>::operator[](std::size_t idx) const noexcept
+{
+    return m_vertices[m_indices[idx]];
+}
+
+
+
+
+template <typename Index>
+auto IndexedVertexArray<Index>::begin() const noexcept -> const_iterator
+{
+    return {*this, 0};
+}
+
+
+
+
+template <typename Index>
+auto IndexedVertexArray<Index>::end() const noexcept -> const_iterator
+{
+    return {*this, m_indices.size()};
+}
+
+
+
+
+template <typename Index>
+auto IndexedVertexArray<Index>::cbegin() const noexcept -> const_iterator
+{
+    return {*this, 0};
+}
+
+
+
+
+template <typename Index>
+auto IndexedVertexArray<Index>::cend() const noexcept -> const_iterator
+{
+    return {*this, m_indices.size()};
+}
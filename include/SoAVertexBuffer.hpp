@@ -0,0 +1,552 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+    class SoAVertexBuffer
+
+    This file defines a structure-of-arrays shadow of an `sf::VertexArray`:
+    positions, colors and texture coordinates live in three separate
+    arrays, so a pass reading only positions (culling, bounds...) streams
+    8 bytes per vertex instead of 20.
+
+    Writes are tracked per field as a dirty index range, and scatter()
+    copies back into the `sf::VertexArray` only the fields and the range
+    that changed, right before drawing. Mutable iterators yield proxies
+    whose fields mark themselves dirty when assigned, not when read:
+
+        for (auto vertex : soa) {
+            if (vertex.position.get().y > floor)
+                vertex.color = sf::Color::Red;      // marks the color only
+            vertex.position.edit().x += speed;      // edit() marks the position
+        }
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include "VertexArray_iterator.hpp"
+
+template <bool is_const> class SoAVertexBuffer_iterator;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class SoAVertexBuffer
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+class SoAVertexBuffer
+{
+public:
+    //* Half-open range of indices written since the last scatter()
+    struct Dirty_range
+    {
+        std::size_t first = 0;
+        std::size_t last  = 0;
+
+        bool empty() const noexcept { return first >= last; }
+        void add(std::size_t first_, std::size_t last_) noexcept;
+    };
+
+    //* Field of a mutable proxy, marking its index dirty on writes only
+    template <typename T>
+    struct field_reference
+    {
+        T&              value;
+        Dirty_range&    dirty;
+        std::size_t     index;
+
+        operator T const&() const noexcept { return value; }
+        T const&        get() const noexcept { return value; }
+
+        // Mark the field dirty and give write access to it
+        T&              edit() const noexcept;
+
+        field_reference const& operator=(T const&) const noexcept;
+        field_reference const& operator=(field_reference const& other) const noexcept { return *this = other.get(); }
+        field_reference const& operator+=(T const& rhs) const noexcept { edit() += rhs; return *this; }
+        field_reference const& operator-=(T const& rhs) const noexcept { edit() -= rhs; return *this; }
+    };
+
+    //* Proxy returned by mutable iterators, shaped like `sf::Vertex`
+    struct reference
+    {
+        field_reference<sf::Vector2f>   position;
+        field_reference<sf::Color>      color;
+        field_reference<sf::Vector2f>   texCoords;
+
+        operator sf::Vertex() const noexcept;
+        reference const& operator=(sf::Vertex const&) const noexcept;
+        // Copy the vertex of another proxy, as in `*a = *b`, marking this one
+        reference const& operator=(reference const&) const noexcept;
+
+        // Exchange the vertices of two proxies and mark both, for std::sort and the like
+        friend void swap(reference lhs, reference rhs) noexcept
+        {
+            sf::Vertex const vertex = lhs;
+            lhs = rhs;
+            rhs = vertex;
+        }
+    };
+
+    //* Proxy returned by const iterators
+    struct const_reference
+    {
+        sf::Vector2f const& position;
+        sf::Color const&    color;
+        sf::Vector2f const& texCoords;
+
+        operator sf::Vertex() const noexcept;
+    };
+
+    using iterator          = SoAVertexBuffer_iterator<false>;
+    using const_iterator    = SoAVertexBuffer_iterator<true>;
+
+private:
+    std::vector<sf::Vector2f>   m_positions;
+    std::vector<sf::Color>      m_colors;
+    std::vector<sf::Vector2f>   m_tex_coords;
+    Dirty_range                 m_dirty_positions;
+    Dirty_range                 m_dirty_colors;
+    Dirty_range                 m_dirty_tex_coords;
+
+public:
+    SoAVertexBuffer() = default;
+    explicit SoAVertexBuffer(sf::VertexArray const&);
+
+    void                    assign(sf::VertexArray const&);
+    void                    scatter(sf::VertexArray&);
+
+    std::size_t             size() const noexcept;
+    bool                    empty() const noexcept;
+    bool                    is_dirty() const noexcept;
+
+    // Read-only field arrays, for position-only (or color-only) passes
+    sf::Vector2f const*     positions() const noexcept;
+    sf::Color const*        colors() const noexcept;
+    sf::Vector2f const*     tex_coords() const noexcept;
+
+    // Writable field arrays, marking [first, last) of that field dirty, clamped to size()
+    sf::Vector2f*           edit_positions(std::size_t first, std::size_t last) noexcept;
+    sf::Color*              edit_colors(std::size_t first, std::size_t last) noexcept;
+    sf::Vector2f*           edit_tex_coords(std::size_t first, std::size_t last) noexcept;
+
+    reference               operator[](std::size_t) noexcept;
+    const_reference         operator[](std::size_t) const noexcept;
+
+    iterator                begin() noexcept;
+    iterator                end() noexcept;
+    const_iterator          begin() const noexcept;
+    const_iterator          end() const noexcept;
+    const_iterator          cbegin() const noexcept;
+    const_iterator          cend() const noexcept;
+
+private:
+    void                    clear_dirty() noexcept;
+
+};
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class SoAVertexBuffer_iterator
+    random-access iterator yielding proxy references.
+    Writing through the proxy of a mutable iterator marks the fields
+    written dirty; reading through it marks nothing.
+
+    @param  is_const    whether the iterator gives read-only access
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+template <bool is_const>
+class SoAVertexBuffer_iterator
+{
+public:
+    using value_type        = sf::Vertex;
+    using difference_type   = std::ptrdiff_t;
+    using reference
+    = std::conditional_t<is_const,
+        SoAVertexBuffer::const_reference,
+        SoAVertexBuffer::reference
+    >;
+    using pointer           = void;
+    using iterator_category = std::random_access_iterator_tag;
+
+private:
+    using buffer_pointer_t
+    = std::conditional_t<is_const,
+        SoAVertexBuffer const*,
+        SoAVertexBuffer*
+    >;
+
+    buffer_pointer_t    m_buffer = nullptr;
+    std::size_t         m_index = 0;
+
+public:
+    SoAVertexBuffer_iterator() noexcept = default;
+
+    SoAVertexBuffer_iterator(buffer_pointer_t buffer, std::size_t idx) noexcept
+        : m_buffer  {buffer}
+        , m_index   {idx}
+    {}
+
+    // need implicit conversion
+    template <bool c = is_const, typename = std::enable_if_t<!c>>
+    operator SoAVertexBuffer_iterator<true>() const noexcept {
+        return {m_buffer, m_index};
+    }
+
+    reference operator*() const noexcept {
+        return (*m_buffer)[m_index];
+    }
+
+    reference operator[](difference_type n) const noexcept {
+        return (*m_buffer)[m_index + n];
+    }
+
+    SoAVertexBuffer_iterator& operator++() noexcept { ++m_index; return *this; }
+    SoAVertexBuffer_iterator& operator--() noexcept { --m_index; return *this; }
+    SoAVertexBuffer_iterator  operator++(int) noexcept { auto copy = *this; ++m_index; return copy; }
+    SoAVertexBuffer_iterator  operator--(int) noexcept { auto copy = *this; --m_index; return copy; }
+    SoAVertexBuffer_iterator& operator+=(difference_type n) noexcept { m_index += n; return *this; }
+    SoAVertexBuffer_iterator& operator-=(difference_type n) noexcept { m_index -= n; return *this; }
+
+    friend SoAVertexBuffer_iterator operator+(SoAVertexBuffer_iterator it, difference_type n) noexcept
+    {
+        return it += n;
+    }
+
+    friend SoAVertexBuffer_iterator operator+(difference_type n, SoAVertexBuffer_iterator it) noexcept
+    {
+        return it += n;
+    }
+
+    friend SoAVertexBuffer_iterator operator-(SoAVertexBuffer_iterator it, difference_type n) noexcept
+    {
+        return it -= n;
+    }
+
+    friend difference_type operator-(SoAVertexBuffer_iterator const& lhs, SoAVertexBuffer_iterator const& rhs) noexcept
+    {
+        return static_cast<difference_type>(lhs.m_index)
+             - static_cast<difference_type>(rhs.m_index);
+    }
+
+    friend bool operator==(SoAVertexBuffer_iterator const& lhs, SoAVertexBuffer_iterator const& rhs) noexcept
+    {
+        return lhs.m_buffer == rhs.m_buffer
+            && lhs.m_index == rhs.m_index;
+    }
+
+    friend bool operator!=(SoAVertexBuffer_iterator const& lhs, SoAVertexBuffer_iterator const& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    friend bool operator<(SoAVertexBuffer_iterator const& lhs, SoAVertexBuffer_iterator const& rhs) noexcept
+    {
+        return lhs.m_index < rhs.m_index;
+    }
+
+    friend bool operator>(SoAVertexBuffer_iterator const& lhs, SoAVertexBuffer_iterator const& rhs) noexcept
+    {
+        return lhs.m_index > rhs.m_index;
+    }
+
+    friend bool operator<=(SoAVertexBuffer_iterator const& lhs, SoAVertexBuffer_iterator const& rhs) noexcept
+    {
+        return lhs.m_index <= rhs.m_index;
+    }
+
+    friend bool operator>=(SoAVertexBuffer_iterator const& lhs, SoAVertexBuffer_iterator const& rhs) noexcept
+    {
+        return lhs.m_index >= rhs.m_index;
+    }
+
+};
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    proxies implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+inline void SoAVertexBuffer::Dirty_range::add(std::size_t first_, std::size_t last_) noexcept
+{
+    if (first_ >= last_) {
+        return;
+    }
+    if (empty()) {
+        first = first_;
+        last  = last_;
+    }
+    else {
+        first = std::min(first, first_);
+        last  = std::max(last, last_);
+    }
+}
+
+
+
+
+template <typename T>
+T& SoAVertexBuffer::field_reference<T>::edit() const noexcept
+{
+    dirty.add(index, index+1);
+    return value;
+}
+
+
+
+
+template <typename T>
+auto SoAVertexBuffer::field_reference<T>::operator=(T const& rhs) const noexcept
+    -> field_reference const&
+{
+    edit() = rhs;
+    return *this;
+}
+
+
+
+
+inline SoAVertexBuffer::reference::operator sf::Vertex() const noexcept
+{
+    return {position.get(), color.get(), texCoords.get()};
+}
+
+
+
+
+inline auto SoAVertexBuffer::reference::operator=(sf::Vertex const& vertex) const noexcept
+    -> reference const&
+{
+    position  = vertex.position;
+    color     = vertex.color;
+    texCoords = vertex.texCoords;
+    return *this;
+}
+
+
+
+
+inline auto SoAVertexBuffer::reference::operator=(reference const& other) const noexcept
+    -> reference const&
+{
+    return *this = static_cast<sf::Vertex>(other);
+}
+
+
+
+
+inline SoAVertexBuffer::const_reference::operator sf::Vertex() const noexcept
+{
+    return {position, color, texCoords};
+}
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    SoAVertexBuffer implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+inline SoAVertexBuffer::SoAVertexBuffer(sf::VertexArray const& va)
+{
+    assign(va);
+}
+
+
+
+
+inline void SoAVertexBuffer::assign(sf::VertexArray const& va)
+{
+    auto const count = va.getVertexCount();
+    m_positions.resize(count);
+    m_colors.resize(count);
+    m_tex_coords.resize(count);
+
+    for (std::size_t i=0; i < count; ++i) {
+        m_positions[i]  = va[i].position;
+        m_colors[i]     = va[i].color;
+        m_tex_coords[i] = va[i].texCoords;
+    }
+    clear_dirty();
+}
+
+
+
+
+inline void SoAVertexBuffer::scatter(sf::VertexArray& va)
+{
+    if (va.getVertexCount() != size()) {
+        va.resize(size());
+        m_dirty_positions.add(0, size());
+        m_dirty_colors.add(0, size());
+        m_dirty_tex_coords.add(0, size());
+    }
+
+    for (auto i = m_dirty_positions.first; i < m_dirty_positions.last; ++i)
+        va[i].position = m_positions[i];
+
+    for (auto i = m_dirty_colors.first; i < m_dirty_colors.last; ++i)
+        va[i].color = m_colors[i];
+
+    for (auto i = m_dirty_tex_coords.first; i < m_dirty_tex_coords.last; ++i)
+        va[i].texCoords = m_tex_coords[i];
+
+    clear_dirty();
+}
+
+
+
+
+inline std::size_t SoAVertexBuffer::size() const noexcept
+{
+    return m_positions.size();
+}
+
+
+
+
+inline bool SoAVertexBuffer::empty() const noexcept
+{
+    return m_positions.empty();
+}
+
+
+
+
+inline bool SoAVertexBuffer::is_dirty() const noexcept
+{
+    return !m_dirty_positions.empty()
+        || !m_dirty_colors.empty()
+        || !m_dirty_tex_coords.empty();
+}
+
+
+
+
+inline sf::Vector2f const* SoAVertexBuffer::positions() const noexcept
+{
+    return m_positions.data();
+}
+
+
+
+
+inline sf::Color const* SoAVertexBuffer::colors() const noexcept
+{
+    return m_colors.data();
+}
+
+
+
+
+inline sf::Vector2f const* SoAVertexBuffer::tex_coords() const noexcept
+{
+    return m_tex_coords.data();
+}
+
+
+
+
+inline sf::Vector2f* SoAVertexBuffer::edit_positions(std::size_t first, std::size_t last) noexcept
+{
+    m_dirty_positions.add(std::min(first, size()), std::min(last, size()));
+    return m_positions.data();
+}
+
+
+
+
+inline sf::Color* SoAVertexBuffer::edit_colors(std::size_t first, std::size_t last) noexcept
+{
+    m_dirty_colors.add(std::min(first, size()), std::min(last, size()));
+    return m_colors.data();
+}
+
+
+
+
+inline sf::Vector2f* SoAVertexBuffer::edit_tex_coords(std::size_t first, std::size_t last) noexcept
+{
+    m_dirty_tex_coords.add(std::min(first, size()), std::min(last, size()));
+    return m_tex_coords.data();
+}
+
+
+
+
+inline auto SoAVertexBuffer::operator[](std::size_t idx) noexcept -> reference
+{
+    return {
+        {m_positions[idx], m_dirty_positions, idx},
+        {m_colors[idx], m_dirty_colors, idx},
+        {m_tex_coords[idx], m_dirty_tex_coords, idx}
+    };
+}
+
+
+
+
+inline auto SoAVertexBuffer::operator[](std::size_t idx) const noexcept -> const_reference
+{
+    return {m_positions[idx], m_colors[idx], m_tex_coords[idx]};
+}
+
+
+
+
+inline auto SoAVertexBuffer::begin() noexcept -> iterator
+{
+    return {this, 0};
+}
+
+
+
+
+inline auto SoAVertexBuffer::end() noexcept -> iterator
+{
+    return {this, size()};
+}
+
+
+
+
+inline auto SoAVertexBuffer::begin() const noexcept -> const_iterator
+{
+    return {this, 0};
+}
+
+
+
+
+inline auto SoAVertexBuffer::end() const noexcept -> const_iterator
+{
+    return {this, size()};
+}
+
+
+
+
+inline auto SoAVertexBuffer::cbegin() const noexcept -> const_iterator
+{
+    return {this, 0};
+}
+
+
+
+
+inline auto SoAVertexBuffer::cend() const noexcept -> const_iterator
+{
+    return {this, size()};
+}
+
+
+
+
+inline void SoAVertexBuffer::clear_dirty() noexcept
+{
+    m_dirty_positions  = {};
+    m_dirty_colors     = {};
+    m_dirty_tex_coords = {};
+}
@@ -0,0 +1,356 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+    class SoftwareRasterizer
+
+    This file defines a CPU stand-in for `sf::RenderTarget::draw()`, to
+    measure a whole vertex pipeline (generate, transform, cull, sort,
+    draw) on machines without a GPU. It assembles the primitives of an
+    array read through `sf::cbegin()` / `sf::cend()`, sets up each
+    triangle and counts the pixels it covers in a coverage buffer:
+
+        SoftwareRasterizer target {1280, 720};
+        target.draw(visible);
+        target.stats().fragments;       // pixels written
+        target.coverage(x, y);          // times pixel (x, y) was covered
+
+    As on a GPU, vertices snap to a subpixel grid and pixel centers are
+    tested exactly, with a tie-breaking rule on edges, so triangles
+    sharing an edge never cover a pixel twice.
+    Colors and textures are ignored, and lines are not rasterized.
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/System/Vector2.hpp>
+#include "VertexArray_iterator.hpp"
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class SoftwareRasterizer
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+class SoftwareRasterizer
+{
+public:
+    struct Stats
+    {
+        std::size_t     vertices    = 0;    // read from the arrays drawn
+        std::size_t     triangles   = 0;    // set up
+        std::size_t     culled      = 0;    // triangles degenerate or off the target
+        std::size_t     fragments   = 0;    // pixels covered, points included
+    };
+
+private:
+    unsigned                    m_width;
+    unsigned                    m_height;
+    std::vector<std::uint32_t>  m_coverage;
+    Stats                       m_stats;
+
+public:
+    SoftwareRasterizer(unsigned width, unsigned height);
+
+    // Zero the coverage buffer and the stats
+    void                    clear();
+
+    void                    draw(sf::VertexArray const& va);
+
+    // Draw the vertices of an input range as primitives of type `type`
+    template <typename Input_it, typename Sentinel>
+    void                    draw(Input_it first, Sentinel last, sf::PrimitiveType type);
+
+    Stats const&            stats() const noexcept;
+    std::uint32_t           coverage(unsigned x, unsigned y) const noexcept;
+
+    unsigned                width() const noexcept;
+    unsigned                height() const noexcept;
+
+private:
+    void                    point(sf::Vector2f) noexcept;
+    void                    triangle(sf::Vector2f, sf::Vector2f, sf::Vector2f) noexcept;
+
+};
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Impl.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace vertex_array::impl
+{
+// Vertices snap to 1/256 of a pixel, pixel centers sit at 128 + 256 * i
+constexpr std::int64_t subpixels = 256;
+
+// Farther coordinates are clamped, keeping the edge functions within 64 bits
+constexpr float max_coordinate = 1 << 20;
+
+
+
+struct Fixed_point
+{
+    std::int64_t    x, y;
+};
+
+
+
+inline Fixed_point snap(sf::Vector2f position) noexcept
+{
+    auto const fixed = [](float v) {
+        return static_cast<std::int64_t>(std::lround(std::clamp(v, -max_coordinate, max_coordinate) * subpixels));
+    };
+    return {fixed(position.x), fixed(position.y)};
+}
+
+
+
+inline std::int64_t floor_div(std::int64_t n, std::int64_t d) noexcept     // d > 0
+{
+    return n >= 0 ? n / d : -((-n + d - 1) / d);
+}
+
+
+
+inline std::int64_t ceil_div(std::int64_t n, std::int64_t d) noexcept      // d > 0
+{
+    return -floor_div(-n, d);
+}
+
+
+
+/**
+ *  Whether pixel centers exactly on the edge `from` -> `to` belong to the
+ *  triangle. Neighbour triangles run a shared edge in opposite directions,
+ *  so exactly one of them owns the centers on it.
+ */
+inline bool owns_edge(Fixed_point from, Fixed_point to) noexcept
+{
+    auto const dx = to.x - from.x;
+    auto const dy = to.y - from.y;
+    return dy < 0 || (dy == 0 && dx > 0);
+}
+
+} // namespace vertex_array::impl
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    SoftwareRasterizer implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+inline SoftwareRasterizer::SoftwareRasterizer(unsigned width, unsigned height)
+    : m_width       {width}
+    , m_height      {height}
+    , m_coverage    (std::size_t{width} * height, 0)
+{
+}
+
+
+
+
+inline void SoftwareRasterizer::clear()
+{
+    std::fill(m_coverage.begin(), m_coverage.end(), 0);
+    m_stats = Stats{};
+}
+
+
+
+
+inline void SoftwareRasterizer::draw(sf::VertexArray const& va)
+{
+    draw(sf::cbegin(va), sf::cend(va), va.getPrimitiveType());
+}
+
+
+
+
+template <typename Input_it, typename Sentinel>
+void SoftwareRasterizer::draw(Input_it first, Sentinel last, sf::PrimitiveType type)
+{
+    // the vertices of the primitive being assembled: the last ones read,
+    // and the first one of a fan
+    sf::Vector2f window[4];
+    std::size_t count = 0;
+
+    for (; first != last; ++first, ++count)
+    {
+        sf::Vector2f const position = (*first).position;
+        ++m_stats.vertices;
+
+        switch (type)
+        {
+            case sf::Points:
+                point(position);
+                break;
+
+            case sf::Triangles:
+                window[count % 3] = position;
+                if (count % 3 == 2) {
+                    triangle(window[0], window[1], window[2]);
+                }
+                break;
+
+            case sf::Quads:
+                window[count % 4] = position;
+                if (count % 4 == 3) {
+                    triangle(window[0], window[1], window[2]);
+                    triangle(window[0], window[2], window[3]);
+                }
+                break;
+
+            case sf::TriangleStrip:
+                if (count >= 2) {
+                    triangle(window[0], window[1], position);
+                }
+                window[0] = window[1];
+                window[1] = position;
+                break;
+
+            case sf::TriangleFan:
+                if (count == 0) {
+                    window[0] = position;
+                }
+                else if (count >= 2) {
+                    triangle(window[0], window[1], position);
+                }
+                window[1] = position;
+                break;
+
+            default:        // lines
+                break;
+        }
+    }
+}
+
+
+
+
+inline auto SoftwareRasterizer::stats() const noexcept -> Stats const&
+{
+    return m_stats;
+}
+
+
+
+
+inline std::uint32_t SoftwareRasterizer::coverage(unsigned x, unsigned y) const noexcept
+{
+    return m_coverage[std::size_t{y} * m_width + x];
+}
+
+
+
+
+inline unsigned SoftwareRasterizer::width() const noexcept
+{
+    return m_width;
+}
+
+
+
+
+inline unsigned SoftwareRasterizer::height() const noexcept
+{
+    return m_height;
+}
+
+
+
+
+inline void SoftwareRasterizer::point(sf::Vector2f position) noexcept
+{
+    auto const x = std::floor(position.x);
+    auto const y = std::floor(position.y);
+    if (x < 0.f || y < 0.f || x >= static_cast<float>(m_width) || y >= static_cast<float>(m_height)) {
+        return;
+    }
+    ++m_coverage[static_cast<std::size_t>(y) * m_width + static_cast<std::size_t>(x)];
+    ++m_stats.fragments;
+}
+
+
+
+
+inline void SoftwareRasterizer::triangle(sf::Vector2f fa, sf::Vector2f fb, sf::Vector2f fc) noexcept
+{
+    using namespace vertex_array::impl;
+    ++m_stats.triangles;
+
+    if (std::isnan(fa.x + fa.y + fb.x + fb.y + fc.x + fc.y)) {
+        ++m_stats.culled;
+        return;
+    }
+
+    // orient the triangle so that its edge functions are positive inside
+    auto const a = snap(fa);
+    auto b = snap(fb);
+    auto c = snap(fc);
+    auto const area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    if (area == 0) {
+        ++m_stats.culled;
+        return;
+    }
+    if (area < 0) {
+        std::swap(b, c);
+    }
+
+    // pixels whose centers may be inside, clipped to the target
+    auto const center = subpixels / 2;
+    auto const first_x = std::max<std::int64_t>(ceil_div(std::min({a.x, b.x, c.x}) - center, subpixels), 0);
+    auto const first_y = std::max<std::int64_t>(ceil_div(std::min({a.y, b.y, c.y}) - center, subpixels), 0);
+    auto const last_x  = std::min(floor_div(std::max({a.x, b.x, c.x}) - center, subpixels), std::int64_t{m_width} - 1);
+    auto const last_y  = std::min(floor_div(std::max({a.y, b.y, c.y}) - center, subpixels), std::int64_t{m_height} - 1);
+    if (first_x > last_x || first_y > last_y) {
+        ++m_stats.culled;
+        return;
+    }
+
+    // inside edge e: w(x, y) = (to.x - from.x) * (y - from.y) - dy * (x - from.x) >= threshold
+    struct Edge
+    {
+        Fixed_point     from;
+        std::int64_t    dx, dy;
+        std::int64_t    threshold;      // 0 if the edge owns the centers on it, 1 otherwise
+    };
+    auto const edge = [](Fixed_point from, Fixed_point to) {
+        return Edge{from, to.x - from.x, to.y - from.y, owns_edge(from, to) ? 0 : 1};
+    };
+    Edge const edges[3] = {edge(a, b), edge(b, c), edge(c, a)};
+
+    // each row is covered on a span, solved exactly per edge
+    std::size_t fragments = 0;
+    for (auto y = first_y; y <= last_y; ++y)
+    {
+        auto const center_y = y * subpixels + center;
+        auto left  = first_x;
+        auto right = last_x;
+        for (auto const& e : edges)
+        {
+            // inside: dy * (center_x - from.x) <= row
+            auto const row = e.dx * (center_y - e.from.y) - e.threshold;
+            if (e.dy > 0) {
+                right = std::min(right, floor_div(floor_div(row, e.dy) + e.from.x - center, subpixels));
+            }
+            else if (e.dy < 0) {
+                left = std::max(left, ceil_div(ceil_div(-row, -e.dy) + e.from.x - center, subpixels));
+            }
+            else if (row < 0) {
+                right = left - 1;
+            }
+        }
+        if (left > right) {
+            continue;
+        }
+
+        std::uint32_t* const pixels = m_coverage.data() + static_cast<std::size_t>(y) * m_width;
+        for (auto x = left; x <= right; ++x)
+            ++pixels[x];
+        fragments += static_cast<std::size_t>(right - left + 1);
+    }
+    m_stats.fragments += fragments;
+}
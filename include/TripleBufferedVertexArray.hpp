@@ -0,0 +1,283 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+    class TripleBufferedVertexArray
+
+    This file defines a vertex array shared by a writer thread (a
+    simulation) and a reader thread (a renderer) without a lock. It holds
+    three `sf::VertexArray`s:
+
+        back    written by the writer
+        middle  the latest published frame, waiting for the reader
+        front   read by the reader
+
+    publish() swaps the back and middle buffers, acquire() swaps the middle
+    and front buffers, each with one atomic exchange of a buffer index.
+    Neither thread ever waits for the other, and the reader always sees
+    a complete frame. Two buffers are not enough for that: the writer
+    would have to wait for the reader to release the one it reads.
+
+    After a swap, the new back buffer holds an older frame. publish()
+    brings it up to date by copying only the vertices written since:
+    the writer records them with mark_dirty() or through the tracking
+    iterators. A change of vertex count or primitive type copies the
+    whole array.
+
+        // simulation thread
+        for (auto it = frames.tracking_begin(); it != frames.tracking_end(); ++it)
+            (*it).edit().position += velocity;  // or mark_dirty(first, last)
+        frames.publish();
+
+        // render thread
+        frames.acquire();
+        window.draw(frames.front());
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include "VertexArray_iterator.hpp"
+#include "VertexArray_tracking.hpp"
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class TripleBufferedVertexArray
+
+    The writer functions must be called from one thread, the reader
+    functions from one (other) thread.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+class TripleBufferedVertexArray
+{
+    static constexpr std::uint8_t index_mask = 0b011;
+    static constexpr std::uint8_t fresh_bit  = 0b100;      // middle holds an unread frame
+    static constexpr std::size_t  cache_line = 64;
+
+public:
+    // Buffers further behind the latest frame are copied whole
+    static constexpr std::size_t  history_size = 8;
+
+private:
+    std::array<sf::VertexArray, 3>                          m_buffers;
+
+    // shared: index of the middle buffer | fresh_bit
+    alignas(cache_line) std::atomic<std::uint8_t>           m_middle {1};
+
+    // writer state
+    using Ranges = std::vector<std::pair<std::size_t, std::size_t>>;
+
+    alignas(cache_line) std::uint8_t                        m_back = 0;
+    VertexArray_dirty_ranges                                m_written;
+    std::uint64_t                                           m_frame = 0;        // frames published
+    std::uint64_t                                           m_reshaped = 0;     // last frame changing size or type
+    std::size_t                                             m_published_count;
+    sf::PrimitiveType                                       m_published_type;
+    std::array<std::uint64_t, 3>                            m_current {};       // per buffer, last frame it holds
+    std::array<Ranges, history_size>                        m_history;          // ranges written by the last frames
+
+    // reader state
+    alignas(cache_line) std::uint8_t                        m_front = 2;
+
+public:
+    explicit TripleBufferedVertexArray(sf::PrimitiveType = sf::Points, std::size_t vertex_count = 0);
+
+    TripleBufferedVertexArray(TripleBufferedVertexArray const&) = delete;
+    TripleBufferedVertexArray& operator=(TripleBufferedVertexArray const&) = delete;
+
+    /* Writer */
+
+    // The array being written, up to date with the last published frame
+    sf::VertexArray&                back() noexcept;
+
+    VertexArray_iterator            write_begin() noexcept;
+    VertexArray_iterator            write_end() noexcept;
+
+    // Iterators recording their writes, see VertexArray_tracking.hpp
+    VertexArray_tracking_iterator   tracking_begin() noexcept;
+    VertexArray_tracking_iterator   tracking_end() noexcept;
+
+    // Record writes made through back() or the plain iterators, clamped to the back buffer
+    void                            mark_dirty(std::size_t first, std::size_t last);
+    void                            mark_dirty(VertexArray_iterator first, VertexArray_iterator last);
+
+    // Hand the back buffer to the reader, then bring the new back buffer up to date
+    void                            publish();
+
+    /* Reader */
+
+    //* Take the latest published frame, if any. @return whether front() changed
+    bool                            acquire() noexcept;
+
+    // The frame being read
+    sf::VertexArray const&          front() const noexcept;
+
+    VertexArray_const_iterator      read_begin() const noexcept;
+    VertexArray_const_iterator      read_end() const noexcept;
+
+};
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    TripleBufferedVertexArray implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+inline TripleBufferedVertexArray::TripleBufferedVertexArray(
+    sf::PrimitiveType   type,
+    std::size_t         vertex_count
+)
+    : m_buffers {
+        sf::VertexArray{type, vertex_count},
+        sf::VertexArray{type, vertex_count},
+        sf::VertexArray{type, vertex_count}
+    }
+    , m_published_count {vertex_count}
+    , m_published_type  {type}
+{
+}
+
+
+
+
+inline sf::VertexArray& TripleBufferedVertexArray::back() noexcept
+{
+    return m_buffers[m_back];
+}
+
+
+
+
+inline VertexArray_iterator TripleBufferedVertexArray::write_begin() noexcept
+{
+    return sf::begin(back());
+}
+
+
+
+
+inline VertexArray_iterator TripleBufferedVertexArray::write_end() noexcept
+{
+    return sf::end(back());
+}
+
+
+
+
+inline VertexArray_tracking_iterator TripleBufferedVertexArray::tracking_begin() noexcept
+{
+    return sf::tracking_begin(back(), m_written);
+}
+
+
+
+
+inline VertexArray_tracking_iterator TripleBufferedVertexArray::tracking_end() noexcept
+{
+    return sf::tracking_end(back(), m_written);
+}
+
+
+
+
+inline void TripleBufferedVertexArray::mark_dirty(std::size_t first, std::size_t last)
+{
+    auto const count = back().getVertexCount();
+    m_written.add(std::min(first, count), std::min(last, count));
+}
+
+
+
+
+inline void TripleBufferedVertexArray::mark_dirty(VertexArray_iterator first, VertexArray_iterator last)
+{
+    auto const begin = sf::begin(back());
+    mark_dirty(
+        static_cast<std::size_t>(first - begin),
+        static_cast<std::size_t>(last - begin)
+    );
+}
+
+
+
+
+inline void TripleBufferedVertexArray::publish()
+{
+    auto const published = m_back;
+    auto const& latest = m_buffers[published];
+
+    ++m_frame;
+    auto& written = m_history[m_frame % history_size];
+    written.assign(m_written.ranges().begin(), m_written.ranges().end());
+    m_written.clear();
+
+    if (latest.getVertexCount() != m_published_count || latest.getPrimitiveType() != m_published_type) {
+        m_reshaped = m_frame;
+        m_published_count = latest.getVertexCount();
+        m_published_type  = latest.getPrimitiveType();
+    }
+    m_current[published] = m_frame;
+
+    // release the frame, acquire the reader's past reads of the middle buffer
+    auto const previous = m_middle.exchange(published | fresh_bit, std::memory_order_acq_rel);
+    m_back = previous & index_mask;
+
+    // the published buffer is only read from now on, by both threads
+    auto& stale = m_buffers[m_back];
+    auto const behind = m_current[m_back];
+
+    if (behind < m_reshaped || m_frame - behind > history_size) {
+        stale = latest;
+    }
+    else {
+        auto const* source = sf::contiguous_begin(latest);
+        auto* target = sf::contiguous_begin(stale);
+        for (auto frame = behind + 1; frame <= m_frame; ++frame) {
+            for (auto const& [first, last] : m_history[frame % history_size])
+                std::copy(source + first, source + std::min(last, latest.getVertexCount()), target + first);
+        }
+    }
+    m_current[m_back] = m_frame;
+}
+
+
+
+
+inline bool TripleBufferedVertexArray::acquire() noexcept
+{
+    if ((m_middle.load(std::memory_order_relaxed) & fresh_bit) == 0) {
+        return false;
+    }
+
+    // release the reads of the front buffer, acquire the published frame
+    m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & index_mask;
+    return true;
+}
+
+
+
+
+inline sf::VertexArray const& TripleBufferedVertexArray::front() const noexcept
+{
+    return m_buffers[m_front];
+}
+
+
+
+
+inline VertexArray_const_iterator TripleBufferedVertexArray::read_begin() const noexcept
+{
+    return sf::cbegin(front());
+}
+
+
+
+
+inline VertexArray_const_iterator TripleBufferedVertexArray::read_end() const noexcept
+{
+    return sf::cend(front());
+}
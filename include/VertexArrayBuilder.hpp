@@ -0,0 +1,223 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+    class VertexArrayBuilder
+
+    This file defines a reusable staging arena for building
+    `sf::VertexArray`s. Vertices are appended into storage that survives
+    clear(), then handed to an array with a single resize and a single
+    bulk copy, instead of growing the array one `append()` at a time.
+
+    A builder kept across frames stops allocating once it has reached
+    the size of the largest array it builds.
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include "VertexArray_iterator.hpp"
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class VertexArrayBuilder
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+class VertexArrayBuilder
+{
+public:
+    using value_type        = sf::Vertex;
+    using iterator          = sf::Vertex*;
+    using const_iterator    = sf::Vertex const*;
+
+private:
+    std::vector<sf::Vertex>     m_arena;
+
+public:
+    VertexArrayBuilder() = default;
+    explicit VertexArrayBuilder(std::size_t capacity);
+
+    void                    reserve(std::size_t);
+    void                    clear() noexcept;
+
+    void                    push_back(sf::Vertex const&);
+    void                    append(sf::Vertex const&);
+    void                    append(sf::VertexArray const&);
+    template <typename Input_it>
+    void                    append(Input_it first, Input_it last);
+
+    // Append `count` default vertices and return the first one, to be filled in place
+    sf::Vertex*             grow(std::size_t count);
+
+    // Output iterator appending to the builder
+    std::back_insert_iterator<VertexArrayBuilder>
+                            back_inserter() noexcept;
+
+    std::size_t             size() const noexcept;
+    std::size_t             capacity() const noexcept;
+    bool                    empty() const noexcept;
+
+    iterator                begin() noexcept;
+    iterator                end() noexcept;
+    const_iterator          begin() const noexcept;
+    const_iterator          end() const noexcept;
+
+    // Copy the staged vertices to `va` (one resize, one bulk copy)
+    void                    build(sf::VertexArray& va) const;
+    sf::VertexArray         build(sf::PrimitiveType) const;
+
+};
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    VertexArrayBuilder implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+inline VertexArrayBuilder::VertexArrayBuilder(std::size_t capacity)
+{
+    m_arena.reserve(capacity);
+}
+
+
+
+
+inline void VertexArrayBuilder::reserve(std::size_t capacity)
+{
+    m_arena.reserve(capacity);
+}
+
+
+
+
+inline void VertexArrayBuilder::clear() noexcept
+{
+    m_arena.clear();
+}
+
+
+
+
+inline void VertexArrayBuilder::push_back(sf::Vertex const& vertex)
+{
+    m_arena.push_back(vertex);
+}
+
+
+
+
+inline void VertexArrayBuilder::append(sf::Vertex const& vertex)
+{
+    m_arena.push_back(vertex);
+}
+
+
+
+
+inline void VertexArrayBuilder::append(sf::VertexArray const& va)
+{
+    m_arena.insert(m_arena.end(), sf::contiguous_begin(va), sf::contiguous_end(va));
+}
+
+
+
+
+template <typename Input_it>
+void VertexArrayBuilder::append(Input_it first, Input_it last)
+{
+    m_arena.insert(m_arena.end(), first, last);
+}
+
+
+
+
+inline sf::Vertex* VertexArrayBuilder::grow(std::size_t count)
+{
+    auto const offset = m_arena.size();
+    m_arena.resize(offset + count);
+    return m_arena.data() + offset;
+}
+
+
+
+
+inline std::back_insert_iterator<VertexArrayBuilder> VertexArrayBuilder::back_inserter() noexcept
+{
+    return std::back_insert_iterator<VertexArrayBuilder>{*this};
+}
+
+
+
+
+inline std::size_t VertexArrayBuilder::size() const noexcept
+{
+    return m_arena.size();
+}
+
+
+
+
+inline std::size_t VertexArrayBuilder::capacity() const noexcept
+{
+    return m_arena.capacity();
+}
+
+
+
+
+inline bool VertexArrayBuilder::empty() const noexcept
+{
+    return m_arena.empty();
+}
+
+
+
+
+inline auto VertexArrayBuilder::begin() noexcept -> iterator
+{
+    return m_arena.data();
+}
+
+
+
+
+inline auto VertexArrayBuilder::end() noexcept -> iterator
+{
+    return m_arena.data() + m_arena.size();
+}
+
+
+
+
+inline auto VertexArrayBuilder::begin() const noexcept -> const_iterator
+{
+    return m_arena.data();
+}
+
+
+
+
+inline auto VertexArrayBuilder::end() const noexcept -> const_iterator
+{
+    return m_arena.data() + m_arena.size();
+}
+
+
+
+
+inline void VertexArrayBuilder::build(sf::VertexArray& va) const
+{
+    va.resize(m_arena.size());
+    std::copy(m_arena.begin(), m_arena.end(), sf::contiguous_begin(va));
+}
+
+
+
+
+inline sf::VertexArray VertexArrayBuilder::build(sf::PrimitiveType type) const
+{
+    sf::VertexArray va {type};
+    build(va);
+    return va;
+}
@@ -0,0 +1,674 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+    class VertexArrayFile
+    save_vertices()
+
+    This file defines a compact binary format for vertex arrays, a writer
+    injected in the `sf` namespace, and a reader that maps the file in
+    memory instead of parsing it.
+
+    A file is a fixed-size header followed by packed vertex records:
+
+        raw         the 20 bytes of `sf::Vertex`, as laid out in memory.
+                    The records are read in place: data() is a contiguous
+                    `sf::Vertex const*` range over the mapping.
+        quantized   12 bytes per vertex: positions and texture coordinates
+                    as 16-bit fractions of their bounding box (stored in
+                    the header), colors unchanged. Decoded on access.
+
+    Numbers are stored in the byte order of the writer; a file is meant to
+    be read on the platform that wrote it.
+
+    On POSIX systems the reader uses mmap(). Elsewhere, the file is read
+    in one block.
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include "VertexArray_iterator.hpp"
+#include "VertexArray_quantize.hpp"
+#include "VertexArray_reduce.hpp"
+#include "VertexArray_view.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SF_VA_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+enum class VertexArrayFile_format : std::uint16_t { raw = 0, quantized = 1 };
+
+class VertexArrayFile_iterator;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Writer
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace sf
+{
+//* @return false if the file could not be written
+bool save_vertices(
+    sf::VertexArray const&,
+    std::string const&      path,
+    VertexArrayFile_format  format = VertexArrayFile_format::raw
+);
+
+} // namespace sf
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Impl.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace vertex_array::impl
+{
+struct File_header
+{
+    char            magic[4]        = {'S', 'F', 'V', 'A'};
+    std::uint16_t   version         = 1;
+    std::uint16_t   format          = 0;
+    std::uint32_t   primitive_type  = 0;
+    std::uint32_t   record_size     = 0;
+    std::uint64_t   vertex_count    = 0;
+    float           positions[4]    = {};   // left, top, width, height
+    float           tex_coords[4]   = {};
+};
+
+// Records start right after the header, aligned for their float fields
+static_assert(sizeof(File_header) == 56 && sizeof(File_header) % alignof(sf::Vertex) == 0);
+
+
+
+struct Quantized_vertex
+{
+    std::uint16_t   position[2];
+    std::uint8_t    color[4];
+    std::uint16_t   tex_coords[2];
+};
+
+static_assert(sizeof(Quantized_vertex) == 12);
+
+
+
+inline std::uint32_t record_size(VertexArrayFile_format format) noexcept
+{
+    return format == VertexArrayFile_format::raw
+        ? static_cast<std::uint32_t>(sizeof(sf::Vertex))
+        : static_cast<std::uint32_t>(sizeof(Quantized_vertex));
+}
+
+
+
+//* Texture coordinates counterpart of sf::bounds()
+inline sf::FloatRect tex_coords_bounds(sf::VertexArray const& va)
+{
+    if (va.getVertexCount() == 0) {
+        return sf::FloatRect{};
+    }
+    Position_bounds b;
+    for (auto const& vertex : sf::vertices(va)) {
+        b.left   = std::min(b.left, vertex.texCoords.x);
+        b.top    = std::min(b.top, vertex.texCoords.y);
+        b.right  = std::max(b.right, vertex.texCoords.x);
+        b.bottom = std::max(b.bottom, vertex.texCoords.y);
+    }
+    return sf::FloatRect{b.left, b.top, b.right - b.left, b.bottom - b.top};
+}
+
+
+
+/**
+ *  Read-only view of a whole file, mapped in memory when the
+ *  platform allows it.
+ */
+class Mapped_file
+{
+    unsigned char const*        m_data = nullptr;
+    std::size_t                 m_size = 0;
+#ifndef SF_VA_MMAP
+    std::vector<unsigned char>  m_buffer;
+#endif
+
+public:
+    Mapped_file() noexcept = default;
+    Mapped_file(Mapped_file&&) noexcept;
+    Mapped_file& operator=(Mapped_file&&) noexcept;
+    ~Mapped_file();
+
+    bool                    open(std::string const& path);
+    void                    close() noexcept;
+
+    unsigned char const*    data() const noexcept { return m_data; }
+    std::size_t             size() const noexcept { return m_size; }
+
+};
+
+
+
+inline Mapped_file::Mapped_file(Mapped_file&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+
+
+inline Mapped_file& Mapped_file::operator=(Mapped_file&& other) noexcept
+{
+    if (this != &other) {
+        close();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+#ifndef SF_VA_MMAP
+        m_buffer = std::move(other.m_buffer);
+#endif
+    }
+    return *this;
+}
+
+
+
+inline Mapped_file::~Mapped_file()
+{
+    close();
+}
+
+
+
+inline bool Mapped_file::open(std::string const& path)
+{
+    close();
+
+#ifdef SF_VA_MMAP
+    int const fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    auto const size = static_cast<std::size_t>(info.st_size);
+    void* const address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (address == MAP_FAILED) {
+        return false;
+    }
+
+    // the whole file is about to be read: start paging it in now
+    ::madvise(address, size, MADV_WILLNEED);
+
+    m_data = static_cast<unsigned char const*>(address);
+    m_size = size;
+    return true;
+#else
+    std::ifstream file {path, std::ios::binary | std::ios::ate};
+    if (!file) {
+        return false;
+    }
+
+    auto const size = static_cast<std::size_t>(file.tellg());
+    m_buffer.resize(size);
+    file.seekg(0);
+    if (size == 0 || !file.read(reinterpret_cast<char*>(m_buffer.data()), size)) {
+        m_buffer.clear();
+        return false;
+    }
+
+    m_data = m_buffer.data();
+    m_size = size;
+    return true;
+#endif
+}
+
+
+
+inline void Mapped_file::close() noexcept
+{
+#ifdef SF_VA_MMAP
+    if (m_data) {
+        ::munmap(const_cast<unsigned char*>(m_data), m_size);
+    }
+#else
+    m_buffer = {};
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
+
+
+
+} // namespace vertex_array::impl
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class VertexArrayFile
+    vertices of a file written by save_vertices(), read without parsing.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+class VertexArrayFile
+{
+public:
+    using value_type        = sf::Vertex;
+    using const_iterator    = VertexArrayFile_iterator;
+
+private:
+    vertex_array::impl::Mapped_file     m_file;
+    vertex_array::impl::File_header     m_header;
+    unsigned char const*                m_records = nullptr;
+
+    // dequantization factors
+    sf::Vector2f                        m_position_origin;
+    sf::Vector2f                        m_position_step;
+    sf::Vector2f                        m_tex_origin;
+    sf::Vector2f                        m_tex_step;
+
+public:
+    VertexArrayFile() noexcept = default;
+
+    //* @return false if the file is missing, truncated or not in this format
+    bool                    open(std::string const& path);
+    void                    close() noexcept;
+    bool                    is_open() const noexcept;
+
+    VertexArrayFile_format  format() const noexcept;
+    sf::PrimitiveType       primitive_type() const noexcept;
+    std::size_t             size() const noexcept;
+    bool                    empty() const noexcept;
+
+    sf::Vertex              operator[](std::size_t) const noexcept;
+    const_iterator          begin() const noexcept;
+    const_iterator          end() const noexcept;
+
+    // Records in place, nullptr unless the file is raw
+    sf::Vertex const*       data() const noexcept;
+
+    // Append vertices [first, first + count) to `va`, return how many were appended
+    std::size_t             read(sf::VertexArray& va, std::size_t first, std::size_t count) const;
+
+    // Replace the vertices and primitive type of `va` by the file's
+    void                    load(sf::VertexArray& va) const;
+
+private:
+    sf::Vertex              decode(std::size_t) const noexcept;
+
+};
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class VertexArrayFile_iterator
+    random-access iterator yielding the decoded vertices of a file.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+class VertexArrayFile_iterator
+{
+public:
+    using value_type        = sf::Vertex;
+    using difference_type   = std::ptrdiff_t;
+    using reference         = sf::Vertex;
+    using pointer           = void;
+    using iterator_category = std::input_iterator_tag;
+#if __cplusplus > 201703L
+    using iterator_concept  = std::random_access_iterator_tag;
+#endif
+
+private:
+    VertexArrayFile const*  m_file = nullptr;
+    std::size_t             m_index = 0;
+
+public:
+    VertexArrayFile_iterator() noexcept = default;
+
+    VertexArrayFile_iterator(VertexArrayFile const* file, std::size_t idx) noexcept
+        : m_file    {file}
+        , m_index   {idx}
+    {}
+
+    reference operator*() const noexcept {
+        return (*m_file)[m_index];
+    }
+
+    reference operator[](difference_type n) const noexcept {
+        return (*m_file)[m_index + n];
+    }
+
+    VertexArrayFile_iterator& operator++() noexcept { ++m_index; return *this; }
+    VertexArrayFile_iterator& operator--() noexcept { --m_index; return *this; }
+    VertexArrayFile_iterator  operator++(int) noexcept { auto copy = *this; ++m_index; return copy; }
+    VertexArrayFile_iterator  operator--(int) noexcept { auto copy = *this; --m_index; return copy; }
+    VertexArrayFile_iterator& operator+=(difference_type n) noexcept { m_index += n; return *this; }
+    VertexArrayFile_iterator& operator-=(difference_type n) noexcept { m_index -= n; return *this; }
+
+    friend VertexArrayFile_iterator operator+(VertexArrayFile_iterator it, difference_type n) noexcept
+    {
+        return it += n;
+    }
+
+    friend VertexArrayFile_iterator operator+(difference_type n, VertexArrayFile_iterator it) noexcept
+    {
+        return it += n;
+    }
+
+    friend VertexArrayFile_iterator operator-(VertexArrayFile_iterator it, difference_type n) noexcept
+    {
+        return it -= n;
+    }
+
+    friend difference_type operator-(VertexArrayFile_iterator const& lhs, VertexArrayFile_iterator const& rhs) noexcept
+    {
+        return static_cast<difference_type>(lhs.m_index)
+             - static_cast<difference_type>(rhs.m_index);
+    }
+
+    friend bool operator==(VertexArrayFile_iterator const& lhs, VertexArrayFile_iterator const& rhs) noexcept
+    {
+        return lhs.m_file == rhs.m_file
+            && lhs.m_index == rhs.m_index;
+    }
+
+    friend bool operator!=(VertexArrayFile_iterator const& lhs, VertexArrayFile_iterator const& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    friend bool operator<(VertexArrayFile_iterator const& lhs, VertexArrayFile_iterator const& rhs) noexcept
+    {
+        return lhs.m_index < rhs.m_index;
+    }
+
+    friend bool operator>(VertexArrayFile_iterator const& lhs, VertexArrayFile_iterator const& rhs) noexcept
+    {
+        return lhs.m_index > rhs.m_index;
+    }
+
+    friend bool operator<=(VertexArrayFile_iterator const& lhs, VertexArrayFile_iterator const& rhs) noexcept
+    {
+        return lhs.m_index <= rhs.m_index;
+    }
+
+    friend bool operator>=(VertexArrayFile_iterator const& lhs, VertexArrayFile_iterator const& rhs) noexcept
+    {
+        return lhs.m_index >= rhs.m_index;
+    }
+
+};
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    save_vertices() implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace sf
+{
+inline bool save_vertices(
+    sf::VertexArray const&  va,
+    std::string const&      path,
+    VertexArrayFile_format  format
+){
+    using namespace vertex_array::impl;
+
+    File_header header;
+    header.format           = static_cast<std::uint16_t>(format);
+    header.primitive_type   = static_cast<std::uint32_t>(va.getPrimitiveType());
+    header.record_size      = record_size(format);
+    header.vertex_count     = va.getVertexCount();
+
+    std::ofstream file {path, std::ios::binary | std::ios::trunc};
+    if (!file) {
+        return false;
+    }
+
+    if (format == VertexArrayFile_format::raw) {
+        file.write(reinterpret_cast<char const*>(&header), sizeof header);
+        file.write(
+            reinterpret_cast<char const*>(sf::contiguous_begin(va)),
+            static_cast<std::streamsize>(va.getVertexCount() * sizeof(sf::Vertex))
+        );
+        return static_cast<bool>(file);
+    }
+
+    auto const positions = sf::bounds(va);
+    auto const tex_coords = tex_coords_bounds(va);
+    header.positions[0]  = positions.left;
+    header.positions[1]  = positions.top;
+    header.positions[2]  = positions.width;
+    header.positions[3]  = positions.height;
+    header.tex_coords[0] = tex_coords.left;
+    header.tex_coords[1] = tex_coords.top;
+    header.tex_coords[2] = tex_coords.width;
+    header.tex_coords[3] = tex_coords.height;
+
+    std::vector<Quantized_vertex> records;
+    records.reserve(va.getVertexCount());
+
+    for (auto const& vertex : sf::vertices(va)) {
+        records.push_back(Quantized_vertex{
+            {
+                quantize(vertex.position.x, positions.left, positions.width),
+                quantize(vertex.position.y, positions.top, positions.height)
+            },
+            {vertex.color.r, vertex.color.g, vertex.color.b, vertex.color.a},
+            {
+                quantize(vertex.texCoords.x, tex_coords.left, tex_coords.width),
+                quantize(vertex.texCoords.y, tex_coords.top, tex_coords.height)
+            }
+        });
+    }
+
+    file.write(reinterpret_cast<char const*>(&header), sizeof header);
+    file.write(
+        reinterpret_cast<char const*>(records.data()),
+        static_cast<std::streamsize>(records.size() * sizeof(Quantized_vertex))
+    );
+    return static_cast<bool>(file);
+}
+
+
+
+} // namespace sf
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    VertexArrayFile implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+inline bool VertexArrayFile::open(std::string const& path)
+{
+    using namespace vertex_array::impl;
+    close();
+
+    Mapped_file file;
+    if (!file.open(path) || file.size() < sizeof(File_header)) {
+        return false;
+    }
+
+    File_header header;
+    std::memcpy(&header, file.data(), sizeof header);
+
+    auto const format = static_cast<VertexArrayFile_format>(header.format);
+    auto const payload = file.size() - sizeof header;
+
+    if (std::memcmp(header.magic, File_header{}.magic, sizeof header.magic) != 0
+        || header.version != File_header{}.version
+        || (format != VertexArrayFile_format::raw && format != VertexArrayFile_format::quantized)
+        || header.record_size != record_size(format)
+        || header.vertex_count > payload / header.record_size)
+    {
+        return false;
+    }
+
+    m_file      = std::move(file);
+    m_header    = header;
+    m_records   = m_file.data() + sizeof header;
+
+    m_position_origin   = {header.positions[0], header.positions[1]};
+    m_position_step     = {quantization_step(header.positions[2]), quantization_step(header.positions[3])};
+    m_tex_origin        = {header.tex_coords[0], header.tex_coords[1]};
+    m_tex_step          = {quantization_step(header.tex_coords[2]), quantization_step(header.tex_coords[3])};
+    return true;
+}
+
+
+
+
+inline void VertexArrayFile::close() noexcept
+{
+    m_file.close();
+    m_header = vertex_array::impl::File_header{};
+    m_records = nullptr;
+}
+
+
+
+
+inline bool VertexArrayFile::is_open() const noexcept
+{
+    return m_records != nullptr;
+}
+
+
+
+
+inline VertexArrayFile_format VertexArrayFile::format() const noexcept
+{
+    return static_cast<VertexArrayFile_format>(m_header.format);
+}
+
+
+
+
+inline sf::PrimitiveType VertexArrayFile::primitive_type() const noexcept
+{
+    return static_cast<sf::PrimitiveType>(m_header.primitive_type);
+}
+
+
+
+
+inline std::size_t VertexArrayFile::size() const noexcept
+{
+    return static_cast<std::size_t>(m_header.vertex_count);
+}
+
+
+
+
+inline bool VertexArrayFile::empty() const noexcept
+{
+    return m_header.vertex_count == 0;
+}
+
+
+
+
+inline sf::Vertex VertexArrayFile::operator[](std::size_t index) const noexcept
+{
+    if (format() == VertexArrayFile_format::raw) {
+        return data()[index];
+    }
+    return decode(index);
+}
+
+
+
+
+inline auto VertexArrayFile::begin() const noexcept -> const_iterator
+{
+    return {this, 0};
+}
+
+
+
+
+inline auto VertexArrayFile::end() const noexcept -> const_iterator
+{
+    return {this, size()};
+}
+
+
+
+
+inline sf::Vertex const* VertexArrayFile::data() const noexcept
+{
+    return format() == VertexArrayFile_format::raw
+        ? reinterpret_cast<sf::Vertex const*>(m_records)
+        : nullptr;
+}
+
+
+
+
+inline std::size_t VertexArrayFile::read(sf::VertexArray& va, std::size_t first, std::size_t count)
+const
+{
+    if (first >= size()) {
+        return 0;
+    }
+    count = std::min(count, size() - first);
+
+    auto const offset = va.getVertexCount();
+    va.resize(offset + count);
+    sf::Vertex* out = sf::contiguous_begin(va) + offset;
+
+    if (format() == VertexArrayFile_format::raw) {
+        std::copy(data() + first, data() + first + count, out);
+    }
+    else {
+        for (std::size_t i=0; i < count; ++i)
+            out[i] = decode(first + i);
+    }
+    return count;
+}
+
+
+
+
+inline void VertexArrayFile::load(sf::VertexArray& va) const
+{
+    va.clear();
+    va.setPrimitiveType(primitive_type());
+    read(va, 0, size());
+}
+
+
+
+
+inline sf::Vertex VertexArrayFile::decode(std::size_t index) const noexcept
+{
+    vertex_array::impl::Quantized_vertex record;
+    std::memcpy(&record, m_records + index * sizeof record, sizeof record);
+
+    return sf::Vertex{
+        {
+            m_position_origin.x + static_cast<float>(record.position[0]) * m_position_step.x,
+            m_position_origin.y + static_cast<float>(record.position[1]) * m_position_step.y
+        },
+        sf::Color{record.color[0], record.color[1], record.color[2], record.color[3]},
+        {
+            m_tex_origin.x + static_cast<float>(record.tex_coords[0]) * m_tex_step.x,
+            m_tex_origin.y + static_cast<float>(record.tex_coords[1]) * m_tex_step.y
+        }
+    };
+}
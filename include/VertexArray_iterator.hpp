@@ -10,6 +10,21 @@
     and injects begin() and end() functions in the `sf` namespace
     to enable range-based for loop for `sf::VertexArray`.
 
+    It also injects contiguous_begin() and contiguous_end(), which return
+    raw `sf::Vertex` pointers for hot loops and standard algorithms,
+    and back_inserter(), an output iterator appending to an array.
+
+    Builds defining `SF_VA_ITERATOR_CHECKED` validate every iterator
+    operation: dereferencing and moving out of [begin, end], comparing
+    iterators of different arrays, and using an iterator after its array
+    reallocated its storage. A failed check calls
+    `vertex_array::impl::iterator_check_handler`, which aborts by default.
+    Without the switch, iterators hold an array pointer and an index only.
+
+    Builds defining `SF_VA_ITERATOR_PROFILE` count traversals, dereferences,
+    steps and jumps per thread and per profiled scope (see
+    VertexArray_profile.hpp). Without the switch the hooks are empty.
+
 * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 #pragma once
 #include <cstddef>
@@ -18,6 +33,11 @@
 #include <type_traits>
 #include <SFML/Graphics/Vertex.hpp>
 #include <SFML/Graphics/VertexArray.hpp>
+#include "VertexArray_profile.hpp"
+#ifdef SF_VA_ITERATOR_CHECKED
+#include <cstdlib>
+#include <iostream>
+#endif
 
 // Forward declarations
 struct VertexArray_iterator;
@@ -25,6 +45,26 @@ struct VertexArray_const_iterator;
 struct VertexArray_const_reverse_iterator;
 struct VertexArray_reverse_iterator;
 
+#ifdef SF_VA_ITERATOR_CHECKED
+namespace vertex_array::impl
+{
+inline void abort_on_iterator_check(char const* what) noexcept
+{
+    std::cerr << "VertexArray iterator check failed: " << what << "\n";
+    std::abort();
+}
+
+
+
+//* Called with a description of the failed check
+inline void (*iterator_check_handler)(char const* what) noexcept = abort_on_iterator_check;
+
+} // namespace vertex_array::impl
+#endif
+
+
+
+
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
     class VertexArray_iterator_interface
     exposes the (mostly) common API for the various iterator types.
@@ -43,16 +83,32 @@ class VertexArray_iterator_interface
         , std::false_type
     >::value;
 
+    // Reverse iterators can't hand out a raw pointer range
+    constexpr static bool is_reverse_iterator
+    = std::conditional_t<
+        std::is_same_v<Concrete_it, VertexArray_reverse_iterator>
+        || std::is_same_v<Concrete_it, VertexArray_const_reverse_iterator>
+        , std::true_type
+        , std::false_type
+    >::value;
+
 public:
-    using value_type
+    using value_type        = sf::Vertex;
+    using difference_type   = std::ptrdiff_t;
+    using pointer
     = std::conditional_t<is_const_iterator,
-        sf::Vertex const,
-        sf::Vertex
+        sf::Vertex const*,
+        sf::Vertex*
     >;
-    using difference_type   = std::ptrdiff_t;
-    using pointer           = std::add_pointer_t<value_type>;
-    using reference         = std::add_lvalue_reference_t<value_type>;
-    using iterator_category = std::bidirectional_iterator_tag;
+    using reference         = std::remove_pointer_t<pointer>&;
+    using iterator_category = std::random_access_iterator_tag;
+#if __cplusplus > 201703L
+    using iterator_concept
+    = std::conditional_t<is_reverse_iterator,
+        std::random_access_iterator_tag,
+        std::contiguous_iterator_tag
+    >;
+#endif
 
 protected:
     using array_pointer_t
@@ -61,79 +117,92 @@ protected:
         sf::VertexArray*
     >;
 
-    array_pointer_t         m_array;
-    mutable std::size_t     m_index;
+    array_pointer_t         m_array = nullptr;
+    std::size_t             m_index = 0;
+#ifdef SF_VA_ITERATOR_CHECKED
+    sf::Vertex const*       m_storage = nullptr;    // storage address at creation
+#endif
 
 protected:
+    VertexArray_iterator_interface() noexcept = default;
     VertexArray_iterator_interface(array_pointer_t, std::size_t) noexcept;
 
-public:
-    reference               operator[](std::size_t) noexcept;
-    reference               operator[](std::size_t) const noexcept;
+    // Checks of the SF_VA_ITERATOR_CHECKED mode, no-ops otherwise
+    void                    check_valid() const noexcept;
+    void                    check_dereferenceable() const noexcept;
+    void                    check_in_range(std::size_t index) const noexcept;
+    static void             check_comparable(Concrete_it const&, Concrete_it const&) noexcept;
 
-    reference               operator*() noexcept;
+public:
+    reference               operator[](difference_type) const noexcept;
     reference               operator*() const noexcept;
-    pointer                 operator->() noexcept;
     pointer                 operator->() const noexcept;
 
     Concrete_it&            operator++() noexcept;
-    Concrete_it&            operator++(int) noexcept;
+    Concrete_it             operator++(int) noexcept;
     Concrete_it&            operator--() noexcept;
-    Concrete_it&            operator--(int) noexcept;
-    Concrete_it&            operator+=(int) noexcept;
-    Concrete_it&            operator-=(int) noexcept;
-    Concrete_it&            operator+=(Concrete_it const&) noexcept;
-    Concrete_it&            operator-=(Concrete_it const&) noexcept;
+    Concrete_it             operator--(int) noexcept;
+    Concrete_it&            operator+=(difference_type) noexcept;
+    Concrete_it&            operator-=(difference_type) noexcept;
 
-    friend Concrete_it operator+(Concrete_it const& it, int n)
+    friend Concrete_it operator+(Concrete_it const& it, difference_type n) noexcept
     {
-        return {*it.m_array, it.m_index+n};
+        auto copy = it;
+        return copy += n;
     }
 
-    friend Concrete_it operator-(Concrete_it const& it, int n)
+    friend Concrete_it operator+(difference_type n, Concrete_it const& it) noexcept
     {
-        return {*it.m_array, it.m_index-n};
+        auto copy = it;
+        return copy += n;
     }
 
-    friend difference_type operator+(Concrete_it const& lhs, Concrete_it const& rhs)
+    friend Concrete_it operator-(Concrete_it const& it, difference_type n) noexcept
     {
-        return lhs.m_index + rhs.m_index;
+        auto copy = it;
+        return copy -= n;
     }
 
-    friend difference_type operator-(Concrete_it const& lhs, Concrete_it const& rhs)
+    friend difference_type operator-(Concrete_it const& lhs, Concrete_it const& rhs) noexcept
     {
-        return lhs.m_index - rhs.m_index;
+        check_comparable(lhs, rhs);
+        return static_cast<difference_type>(lhs.m_index)
+             - static_cast<difference_type>(rhs.m_index);
     }
 
-    friend bool operator==(Concrete_it const& lhs, Concrete_it const& rhs)
+    friend bool operator==(Concrete_it const& lhs, Concrete_it const& rhs) noexcept
     {
         return lhs.m_array == rhs.m_array
             && lhs.m_index == rhs.m_index;
     }
 
-    friend bool operator!=(Concrete_it const& lhs, Concrete_it const& rhs)
+    friend bool operator!=(Concrete_it const& lhs, Concrete_it const& rhs) noexcept
     {
         return lhs.m_array != rhs.m_array
             || lhs.m_index != rhs.m_index;
     }
 
-    friend bool operator<(Concrete_it const& lhs, Concrete_it const& rhs)
+    friend bool operator<(Concrete_it const& lhs, Concrete_it const& rhs) noexcept
     {
+        check_comparable(lhs, rhs);
         return lhs.m_index < rhs.m_index;
     }
 
-    friend bool operator>(Concrete_it const& lhs, Concrete_it const& rhs)
+    friend bool operator>(Concrete_it const& lhs, Concrete_it const& rhs) noexcept
     {
-        return lhs.m_index < rhs.m_index;
+        check_comparable(lhs, rhs);
+        return lhs.m_index > rhs.m_index;
     }
 
-    friend bool operator<=(Concrete_it const& lhs, Concrete_it const& rhs)
+    friend bool operator<=(Concrete_it const& lhs, Concrete_it const& rhs) noexcept
     {
+        check_comparable(lhs, rhs);
         return lhs.m_index <= rhs.m_index;
     }
 
-    friend bool operator>=(Concrete_it const& lhs, Concrete_it const& rhs)
+    friend bool operator>=(Concrete_it const& lhs, Concrete_it const& rhs) noexcept
     {
+        check_comparable(lhs, rhs);
         return lhs.m_index >= rhs.m_index;
     }
 
@@ -148,6 +217,8 @@ public:
 struct VertexArray_const_iterator
     : public VertexArray_iterator_interface<VertexArray_const_iterator>
 {
+    VertexArray_const_iterator() noexcept = default;
+
     VertexArray_const_iterator(sf::VertexArray const& array, std::size_t idx)
     noexcept
         : VertexArray_iterator_interface{&array, idx}
@@ -160,6 +231,8 @@ struct VertexArray_const_iterator
 struct VertexArray_iterator
     : public VertexArray_iterator_interface<VertexArray_iterator>
 {
+    VertexArray_iterator() noexcept = default;
+
     VertexArray_iterator(sf::VertexArray& array, std::size_t idx) noexcept
         : VertexArray_iterator_interface{&array, idx}
     {}
@@ -176,6 +249,8 @@ struct VertexArray_iterator
 struct VertexArray_const_reverse_iterator
     : public VertexArray_iterator_interface<VertexArray_const_reverse_iterator>
 {
+    VertexArray_const_reverse_iterator() noexcept = default;
+
     VertexArray_const_reverse_iterator(sf::VertexArray const& array, std::size_t idx)
     noexcept
         : VertexArray_iterator_interface{&array, idx}
@@ -186,11 +261,14 @@ struct VertexArray_const_reverse_iterator
 
     reference operator*() const noexcept
     {
+        check_dereferenceable();
+        vertex_array::impl::profile_dereference();
         return (*m_array)[m_array->getVertexCount() - 1 - m_index];
     }
 
     pointer operator->() const noexcept
     {
+        check_dereferenceable();
         return &((*m_array)[m_array->getVertexCount() - 1 - m_index]);
     }
 
@@ -202,6 +280,8 @@ struct VertexArray_const_reverse_iterator
 struct VertexArray_reverse_iterator
     : public VertexArray_iterator_interface<VertexArray_reverse_iterator>
 {
+    VertexArray_reverse_iterator() noexcept = default;
+
     VertexArray_reverse_iterator(sf::VertexArray& array, std::size_t idx)
     noexcept
         : VertexArray_iterator_interface{&array, idx}
@@ -215,31 +295,59 @@ struct VertexArray_reverse_iterator
         return {*m_array, m_index};
     }
 
-    reference operator*() noexcept
-    {
-        return (*m_array)[m_array->getVertexCount() - 1 - m_index];
-    }
-
     reference operator*() const noexcept
     {
+        check_dereferenceable();
+        vertex_array::impl::profile_dereference();
         return (*m_array)[m_array->getVertexCount() - 1 - m_index];
     }
 
-    pointer operator->() noexcept
+    pointer operator->() const noexcept
     {
+        check_dereferenceable();
         return &((*m_array)[m_array->getVertexCount() - 1 - m_index]);
     }
 
-    pointer operator->() const noexcept
+};
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class VertexArray_back_insert_iterator
+    output iterator calling `sf::VertexArray::append()` on assignment.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+class VertexArray_back_insert_iterator
+{
+    sf::VertexArray*    m_array = nullptr;
+
+public:
+    using value_type        = void;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = void;
+    using reference         = void;
+    using iterator_category = std::output_iterator_tag;
+
+    VertexArray_back_insert_iterator() noexcept = default;
+
+    explicit VertexArray_back_insert_iterator(sf::VertexArray& array) noexcept
+        : m_array {&array}
+    {}
+
+    VertexArray_back_insert_iterator& operator=(sf::Vertex const& vertex)
     {
-        return &((*m_array)[m_array->getVertexCount() - 1 - m_index]);
+        m_array->append(vertex);
+        return *this;
     }
 
+    VertexArray_back_insert_iterator& operator*() noexcept { return *this; }
+    VertexArray_back_insert_iterator& operator++() noexcept { return *this; }
+    VertexArray_back_insert_iterator  operator++(int) noexcept { return *this; }
 
 };
 
 
 
+
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
     specialize std::iterator_traits
 * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
@@ -251,6 +359,9 @@ template <> struct iterator_traits<VertexArray_iterator> {
     using pointer           = sf::Vertex*;
     using reference         = sf::Vertex&;
     using iterator_category = std::random_access_iterator_tag;
+#if __cplusplus > 201703L
+    using iterator_concept  = std::contiguous_iterator_tag;
+#endif
 };
 
 
@@ -261,6 +372,9 @@ template <> struct iterator_traits<VertexArray_const_iterator> {
     using pointer           = sf::Vertex const*;
     using reference         = sf::Vertex const&;
     using iterator_category = std::random_access_iterator_tag;
+#if __cplusplus > 201703L
+    using iterator_concept  = std::contiguous_iterator_tag;
+#endif
 };
 
 
@@ -272,6 +386,9 @@ template <> struct iterator_traits<VertexArray_reverse_iterator> {
     using pointer           = sf::Vertex*;
     using reference         = sf::Vertex&;
     using iterator_category = std::random_access_iterator_tag;
+#if __cplusplus > 201703L
+    using iterator_concept  = std::random_access_iterator_tag;
+#endif
 };
 
 
@@ -282,6 +399,9 @@ template <> struct iterator_traits<VertexArray_const_reverse_iterator> {
     using pointer           = sf::Vertex const*;
     using reference         = sf::Vertex const&;
     using iterator_category = std::random_access_iterator_tag;
+#if __cplusplus > 201703L
+    using iterator_concept  = std::random_access_iterator_tag;
+#endif
 };
 
 
@@ -307,12 +427,18 @@ VertexArray_const_reverse_iterator  rbegin(sf::VertexArray const&) noexcept;
 VertexArray_const_reverse_iterator  rend(sf::VertexArray const&) noexcept;
 VertexArray_const_reverse_iterator  crbegin(sf::VertexArray const&) noexcept;
 VertexArray_const_reverse_iterator  crend(sf::VertexArray const&) noexcept;
+sf::Vertex*                         contiguous_begin(sf::VertexArray&) noexcept;
+sf::Vertex*                         contiguous_end(sf::VertexArray&) noexcept;
+sf::Vertex const*                   contiguous_begin(sf::VertexArray const&) noexcept;
+sf::Vertex const*                   contiguous_end(sf::VertexArray const&) noexcept;
+VertexArray_back_insert_iterator    back_inserter(sf::VertexArray&) noexcept;
 
 
 
 
 inline VertexArray_iterator begin(sf::VertexArray& va) noexcept
 {
+    vertex_array::impl::profile_traversal();
     return {va, 0};
 }
 
@@ -329,6 +455,7 @@ inline VertexArray_iterator end(sf::VertexArray& va) noexcept
 
 inline VertexArray_const_iterator begin(sf::VertexArray const& va) noexcept
 {
+    vertex_array::impl::profile_traversal();
     return {va, 0};
 }
 
@@ -345,6 +472,7 @@ inline VertexArray_const_iterator end(sf::VertexArray const& va) noexcept
 
 inline VertexArray_const_iterator cbegin(sf::VertexArray const& va) noexcept
 {
+    vertex_array::impl::profile_traversal();
     return {va, 0};
 }
 
@@ -361,6 +489,7 @@ inline VertexArray_const_iterator cend(sf::VertexArray const& va) noexcept
 
 inline VertexArray_reverse_iterator rbegin(sf::VertexArray& va) noexcept
 {
+    vertex_array::impl::profile_traversal();
     return {va, 0};
 }
 
@@ -377,6 +506,7 @@ inline VertexArray_reverse_iterator rend(sf::VertexArray& va) noexcept
 
 inline VertexArray_const_reverse_iterator rbegin(sf::VertexArray const& va) noexcept
 {
+    vertex_array::impl::profile_traversal();
     return {va, 0};
 }
 
@@ -393,6 +523,7 @@ inline VertexArray_const_reverse_iterator rend(sf::VertexArray const& va) noexce
 
 inline VertexArray_const_reverse_iterator crbegin(sf::VertexArray const& va) noexcept
 {
+    vertex_array::impl::profile_traversal();
     return {va, 0};
 }
 
@@ -406,6 +537,58 @@ inline VertexArray_const_reverse_iterator crend(sf::VertexArray const& va) noexc
 
 
 
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    contiguous_begin() and contiguous_end()
+
+    `sf::VertexArray` stores its vertices in a `std::vector`, so the address
+    of the first vertex is fetched once and the range is walked as a plain
+    pointer range. Pointers are contiguous iterators: standard algorithms
+    lower copies to memmove and loops are open to autovectorization.
+
+    The returned pointers are invalidated by anything that reallocates
+    the array (`append`, `resize`...). An empty array yields an empty
+    range made of two null pointers.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+inline sf::Vertex* contiguous_begin(sf::VertexArray& va) noexcept
+{
+    return va.getVertexCount() != 0 ? &va[0] : nullptr;
+}
+
+
+
+
+inline sf::Vertex* contiguous_end(sf::VertexArray& va) noexcept
+{
+    return contiguous_begin(va) + va.getVertexCount();
+}
+
+
+
+
+inline sf::Vertex const* contiguous_begin(sf::VertexArray const& va) noexcept
+{
+    return va.getVertexCount() != 0 ? &va[0] : nullptr;
+}
+
+
+
+
+inline sf::Vertex const* contiguous_end(sf::VertexArray const& va) noexcept
+{
+    return contiguous_begin(va) + va.getVertexCount();
+}
+
+
+
+
+inline VertexArray_back_insert_iterator back_inserter(sf::VertexArray& va) noexcept
+{
+    return VertexArray_back_insert_iterator{va};
+}
+
+
+
 } // namespace sf
 
 
@@ -420,38 +603,85 @@ VertexArray_iterator_interface(array_pointer_t pointer, std::size_t index)
 noexcept
     : m_array   {pointer}
     , m_index   {index}
+#ifdef SF_VA_ITERATOR_CHECKED
+    , m_storage {sf::contiguous_begin(*pointer)}
+#endif
 {
+    check_in_range(index);
 }
 
 
 
 
 template <typename Concrete_it>
-auto VertexArray_iterator_interface<Concrete_it>::operator[](std::size_t idx) noexcept
-    -> typename VertexArray_iterator_interface<Concrete_it>::reference
+void VertexArray_iterator_interface<Concrete_it>::check_valid() const noexcept
 {
-    return *(Concrete_it{*m_array, idx});
+#ifdef SF_VA_ITERATOR_CHECKED
+    if (m_array == nullptr) {
+        vertex_array::impl::iterator_check_handler("singular iterator");
+    }
+    else if (sf::contiguous_begin(*m_array) != m_storage) {
+        vertex_array::impl::iterator_check_handler("iterator invalidated by a reallocation");
+    }
+#endif
 }
 
 
 
 
 template <typename Concrete_it>
-auto VertexArray_iterator_interface<Concrete_it>::operator[](std::size_t idx)
+void VertexArray_iterator_interface<Concrete_it>::check_dereferenceable() const noexcept
+{
+#ifdef SF_VA_ITERATOR_CHECKED
+    check_valid();
+    if (m_array && m_index >= m_array->getVertexCount()) {
+        vertex_array::impl::iterator_check_handler("dereferencing an iterator out of range");
+    }
+#endif
+}
+
+
+
+
+template <typename Concrete_it>
+void VertexArray_iterator_interface<Concrete_it>::check_in_range(std::size_t index)
 const noexcept
-    -> typename VertexArray_iterator_interface<Concrete_it>::reference
 {
-    return *(Concrete_it{*m_array, idx});
+#ifdef SF_VA_ITERATOR_CHECKED
+    check_valid();
+    if (m_array && index > m_array->getVertexCount()) {
+        vertex_array::impl::iterator_check_handler("iterator moved out of range");
+    }
+#else
+    (void)index;
+#endif
+}
+
+
+
+
+template <typename Concrete_it>
+void VertexArray_iterator_interface<Concrete_it>::check_comparable(
+    [[maybe_unused]] Concrete_it const& lhs,
+    [[maybe_unused]] Concrete_it const& rhs
+) noexcept
+{
+#ifdef SF_VA_ITERATOR_CHECKED
+    if (lhs.m_array != rhs.m_array) {
+        vertex_array::impl::iterator_check_handler("comparing iterators of different arrays");
+    }
+#endif
 }
 
 
 
 
 template <typename Concrete_it>
-auto VertexArray_iterator_interface<Concrete_it>::operator*() noexcept
+auto VertexArray_iterator_interface<Concrete_it>::operator[](difference_type n)
+const noexcept
     -> typename VertexArray_iterator_interface<Concrete_it>::reference
 {
-    return (*m_array)[m_index];
+    return *(static_cast<Concrete_it const&>(*this) + n);
 }
 
 
@@ -462,17 +692,23 @@ auto VertexArray_iterator_interface<Concrete_it>::operator*()
 const noexcept
     -> typename VertexArray_iterator_interface<Concrete_it>::reference
 {
+    check_dereferenceable();
+    vertex_array::impl::profile_dereference();
     return (*m_array)[m_index];
 }
 
 
 
 
+// Computed from the array's storage address so that it stays valid for
+// the past-the-end iterator, as std::to_address() requires.
 template <typename Concrete_it>
-auto VertexArray_iterator_interface<Concrete_it>::operator->() noexcept
+auto VertexArray_iterator_interface<Concrete_it>::operator->()
+const noexcept
     -> typename VertexArray_iterator_interface<Concrete_it>::pointer
 {
-    return &(*m_array)[m_index];
+    check_in_range(m_index);
+    return sf::contiguous_begin(*m_array) + m_index;
 }
 
 
@@ -482,6 +718,8 @@ template <typename Concrete_it>
 Concrete_it& VertexArray_iterator_interface<Concrete_it>::operator++()
 noexcept
 {
+    check_in_range(m_index + 1);
+    vertex_array::impl::profile_step();
     ++m_index;
     return (static_cast<Concrete_it&>(*this));
 }
@@ -490,11 +728,14 @@ noexcept
 
 
 template <typename Concrete_it>
-Concrete_it& VertexArray_iterator_interface<Concrete_it>::operator++(int)
+Concrete_it VertexArray_iterator_interface<Concrete_it>::operator++(int)
 noexcept
 {
+    auto copy = static_cast<Concrete_it&>(*this);
+    check_in_range(m_index + 1);
+    vertex_array::impl::profile_step();
     ++m_index;
-    return (static_cast<Concrete_it&>(*this));
+    return copy;
 }
 
 
@@ -504,7 +745,9 @@ template <typename Concrete_it>
 Concrete_it& VertexArray_iterator_interface<Concrete_it>::operator--()
 noexcept
 {
-    ++m_index;
+    check_in_range(m_index - 1);
+    vertex_array::impl::profile_step();
+    --m_index;
     return (static_cast<Concrete_it&>(*this));
 }
 
@@ -512,19 +755,24 @@ noexcept
 
 
 template <typename Concrete_it>
-Concrete_it& VertexArray_iterator_interface<Concrete_it>::operator--(int)
+Concrete_it VertexArray_iterator_interface<Concrete_it>::operator--(int)
 noexcept
 {
-    ++m_index;
-    return (static_cast<Concrete_it&>(*this));
+    auto copy = static_cast<Concrete_it&>(*this);
+    check_in_range(m_index - 1);
+    vertex_array::impl::profile_step();
+    --m_index;
+    return copy;
 }
 
 
 
 
 template <typename Concrete_it>
-Concrete_it& VertexArray_iterator_interface<Concrete_it>::operator+=(int n) noexcept
+Concrete_it& VertexArray_iterator_interface<Concrete_it>::operator+=(difference_type n) noexcept
 {
+    check_in_range(m_index + n);
+    vertex_array::impl::profile_jump(n);
     m_index += n;
     return (static_cast<Concrete_it&>(*this));
 }
@@ -533,8 +781,10 @@ Concrete_it& VertexArray_iterator_interface<Concrete_it>::operator+=(int n) noex
 
 
 template <typename Concrete_it>
-Concrete_it& VertexArray_iterator_interface<Concrete_it>::operator-=(int n) noexcept
+Concrete_it& VertexArray_iterator_interface<Concrete_it>::operator-=(difference_type n) noexcept
 {
+    check_in_range(m_index - n);
+    vertex_array::impl::profile_jump(n);
     m_index -= n;
     return (static_cast<Concrete_it&>(*this));
 }
@@ -542,19 +792,34 @@ Concrete_it& VertexArray_iterator_interface<Concrete_it>::operator-=(int n) noex
 
 
 
-template <typename Concrete_it>
-Concrete_it& VertexArray_iterator_interface<Concrete_it>::operator+=(Concrete_it const& rhs) noexcept
-{
-    m_index += rhs.m_index;
-    return (static_cast<Concrete_it&>(*this));
-}
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Unchecked iterators cost an array pointer and an index
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef SF_VA_ITERATOR_CHECKED
+static_assert(sizeof(VertexArray_iterator) == sizeof(void*) + sizeof(std::size_t));
+static_assert(sizeof(VertexArray_const_iterator) == sizeof(void*) + sizeof(std::size_t));
+static_assert(std::is_trivially_copyable_v<VertexArray_iterator>);
+static_assert(std::is_trivially_copyable_v<VertexArray_const_iterator>);
+#endif
 
 
 
 
-template <typename Concrete_it>
-Concrete_it& VertexArray_iterator_interface<Concrete_it>::operator-=(Concrete_it const& rhs) noexcept
-{
-    m_index -= rhs.m_index;
-    return (static_cast<Concrete_it&>(*this));
-}
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    C++20 iterator concepts conformance
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#if __cplusplus > 201703L
+static_assert(std::contiguous_iterator<VertexArray_iterator>);
+static_assert(std::contiguous_iterator<VertexArray_const_iterator>);
+static_assert(std::random_access_iterator<VertexArray_reverse_iterator>);
+static_assert(std::random_access_iterator<VertexArray_const_reverse_iterator>);
+
+static_assert(std::sized_sentinel_for<VertexArray_iterator, VertexArray_iterator>);
+static_assert(std::sized_sentinel_for<VertexArray_const_iterator, VertexArray_const_iterator>);
+static_assert(std::sized_sentinel_for<VertexArray_reverse_iterator, VertexArray_reverse_iterator>);
+static_assert(std::sized_sentinel_for<VertexArray_const_reverse_iterator, VertexArray_const_reverse_iterator>);
+
+static_assert(std::output_iterator<VertexArray_iterator, sf::Vertex const&>);
+static_assert(std::output_iterator<VertexArray_reverse_iterator, sf::Vertex const&>);
+static_assert(std::output_iterator<VertexArray_back_insert_iterator, sf::Vertex const&>);
+#endif
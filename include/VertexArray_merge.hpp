@@ -0,0 +1,353 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+    class VertexArray_merge_table
+    merge()
+
+    This file injects merge() in the `sf` namespace. It concatenates a
+    range of `sf::VertexArray`s into one array, applying one
+    `sf::Transform` per input array, so that many small batches sharing
+    a texture are drawn with a single call:
+
+        std::vector<sf::VertexArray> pieces = ...;
+        std::vector<sf::Transform>   transforms = ...;
+        sf::VertexArray batch;
+        auto table = sf::merge(pieces.begin(), pieces.end(), transforms.begin(), batch);
+
+    The output is resized once to the total vertex count, and its vertices
+    are copied and transformed in chunks spread over several threads for
+    large batches. The output takes the primitive type of the first array:
+    only independent primitives (points, lines, triangles, quads) keep
+    their meaning once concatenated.
+
+    The returned table locates each input in the output, so a piece can
+    be patched in place later without merging again.
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include "VertexArray_iterator.hpp"
+#include "VertexArray_parallel.hpp"
+#include "VertexArray_transform.hpp"
+#include "VertexArray_view.hpp"
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class VertexArray_merge_table
+    offsets of the merged arrays in the output array.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+class VertexArray_merge_table
+{
+    std::vector<std::size_t>    m_offsets {0};
+
+public:
+    VertexArray_merge_table() = default;
+    explicit VertexArray_merge_table(std::vector<std::size_t> offsets) noexcept;
+
+    // Number of merged arrays
+    std::size_t             size() const noexcept;
+    bool                    empty() const noexcept;
+
+    // Total number of vertices
+    std::size_t             vertex_count() const noexcept;
+
+    // First vertex and vertex count of a merged array in the output
+    std::size_t             offset(std::size_t piece) const noexcept;
+    std::size_t             count(std::size_t piece) const noexcept;
+
+    // Vertices of a merged array in the output
+    VertexArray_view<VertexArray_iterator>
+                            piece(sf::VertexArray& merged, std::size_t piece) const noexcept;
+
+    /**
+     *  Overwrite a merged array in `merged` with the transformed vertices
+     *  of `source`.
+     *
+     *  @return false if `source` does not have the vertex count of the piece
+     */
+    bool                    patch(
+                                sf::VertexArray&        merged,
+                                std::size_t             piece,
+                                sf::VertexArray const&  source,
+                                sf::Transform const&    transform = sf::Transform::Identity
+                            ) const;
+
+};
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    merge()
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace sf
+{
+/**
+ *  Replace the content of `out` with the vertices of the arrays in
+ *  [first, last), each transformed by the matching element of the
+ *  range starting at `transforms`. `out` must not be one of the arrays.
+ *
+ *  @param  first, last     forward range of `sf::VertexArray const&`
+ *  @param  transforms      input range of `sf::Transform const&`, one per array
+ */
+template <typename Array_it, typename Transform_it>
+VertexArray_merge_table
+merge(Array_it first, Array_it last, Transform_it transforms, sf::VertexArray& out);
+
+// Same without transforms
+template <typename Array_it>
+VertexArray_merge_table
+merge(Array_it first, Array_it last, sf::VertexArray& out);
+
+} // namespace sf
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Impl.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace vertex_array::impl
+{
+// Batches with more vertices are copied on several threads
+constexpr std::size_t merge_parallel_threshold = 1 << 16;
+
+
+
+inline bool is_identity(sf::Transform const& transform) noexcept
+{
+    float const* const m  = transform.getMatrix();
+    float const* const id = sf::Transform::Identity.getMatrix();
+    return std::equal(m, m + 16, id);
+}
+
+
+
+struct Merge_source
+{
+    sf::Vertex const*   vertices;
+    sf::Transform       transform;
+    bool                identity;
+};
+
+
+
+/**
+ *  Copy the output vertices [first, last) from the sources, where source
+ *  `i` starts at `offsets[i]` in the output.
+ */
+inline void merge_chunk(
+    std::vector<Merge_source> const&    sources,
+    std::vector<std::size_t> const&     offsets,
+    sf::Vertex*                         out,
+    std::size_t                         first,
+    std::size_t                         last
+){
+    // last source starting at or before `first`
+    auto piece = static_cast<std::size_t>(
+        std::upper_bound(offsets.begin(), offsets.end() - 1, first) - offsets.begin()
+    ) - 1;
+
+    for (; first < last; ++piece)
+    {
+        auto const end   = std::min(last, offsets[piece + 1]);
+        auto const count = end - first;
+        if (count == 0) {
+            continue;
+        }
+
+        auto const& source = sources[piece];
+        std::copy_n(source.vertices + (first - offsets[piece]), count, out + first);
+        if (!source.identity) {
+            transform(out + first, count, source.transform);
+        }
+        first = end;
+    }
+}
+
+
+
+// Endless range of identity transforms
+struct Identity_iterator
+{
+    sf::Transform const& operator*() const noexcept { return sf::Transform::Identity; }
+    Identity_iterator& operator++() noexcept { return *this; }
+};
+
+
+
+inline std::size_t merge_threads(std::size_t count) noexcept
+{
+    static std::size_t const hardware = std::max(std::thread::hardware_concurrency(), 1u);
+    return std::min(hardware, count / merge_parallel_threshold + 1);
+}
+
+
+
+} // namespace vertex_array::impl
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    merge() implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace sf
+{
+template <typename Array_it, typename Transform_it>
+VertexArray_merge_table
+merge(Array_it first, Array_it last, Transform_it transforms, sf::VertexArray& out)
+{
+    using namespace vertex_array::impl;
+
+    std::vector<Merge_source> sources;
+    std::vector<std::size_t> offsets {0};
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+        typename std::iterator_traits<Array_it>::iterator_category>)
+    {
+        auto const pieces = static_cast<std::size_t>(std::distance(first, last));
+        sources.reserve(pieces);
+        offsets.reserve(pieces + 1);
+    }
+
+    for (; first != last; ++first, ++transforms)
+    {
+        sf::VertexArray const& va = *first;
+        sf::Transform const& transform = *transforms;
+
+        if (sources.empty()) {
+            out.setPrimitiveType(va.getPrimitiveType());
+        }
+        sources.push_back(Merge_source{sf::contiguous_begin(va), transform, is_identity(transform)});
+        offsets.push_back(offsets.back() + va.getVertexCount());
+    }
+
+    auto const total = offsets.back();
+    out.resize(total);
+    sf::Vertex* const vertices = sf::contiguous_begin(out);
+
+    auto const threads = merge_threads(total);
+    if (threads <= 1) {
+        merge_chunk(sources, offsets, vertices, 0, total);
+        return VertexArray_merge_table{std::move(offsets)};
+    }
+
+    auto const bounds = chunk_boundaries(reinterpret_cast<std::uintptr_t>(vertices), total, threads);
+    std::vector<std::thread> workers;
+    workers.reserve(bounds.size() - 1);
+    for (std::size_t i=1; i < bounds.size(); ++i) {
+        workers.emplace_back([&, i] {
+            merge_chunk(sources, offsets, vertices, bounds[i-1], bounds[i]);
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+
+    return VertexArray_merge_table{std::move(offsets)};
+}
+
+
+
+
+template <typename Array_it>
+VertexArray_merge_table
+merge(Array_it first, Array_it last, sf::VertexArray& out)
+{
+    return sf::merge(first, last, vertex_array::impl::Identity_iterator{}, out);
+}
+
+} // namespace sf
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    VertexArray_merge_table implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+inline VertexArray_merge_table::VertexArray_merge_table(std::vector<std::size_t> offsets) noexcept
+    : m_offsets {std::move(offsets)}
+{
+}
+
+
+
+
+inline std::size_t VertexArray_merge_table::size() const noexcept
+{
+    return m_offsets.size() - 1;
+}
+
+
+
+
+inline bool VertexArray_merge_table::empty() const noexcept
+{
+    return m_offsets.size() == 1;
+}
+
+
+
+
+inline std::size_t VertexArray_merge_table::vertex_count() const noexcept
+{
+    return m_offsets.back();
+}
+
+
+
+
+inline std::size_t VertexArray_merge_table::offset(std::size_t piece) const noexcept
+{
+    return m_offsets[piece];
+}
+
+
+
+
+inline std::size_t VertexArray_merge_table::count(std::size_t piece) const noexcept
+{
+    return m_offsets[piece + 1] - m_offsets[piece];
+}
+
+
+
+
+inline VertexArray_view<VertexArray_iterator>
+VertexArray_merge_table::piece(sf::VertexArray& merged, std::size_t piece) const noexcept
+{
+    return {
+        VertexArray_iterator{merged, m_offsets[piece]},
+        VertexArray_iterator{merged, m_offsets[piece + 1]}
+    };
+}
+
+
+
+
+inline bool VertexArray_merge_table::patch(
+    sf::VertexArray&        merged,
+    std::size_t             piece,
+    sf::VertexArray const&  source,
+    sf::Transform const&    transform
+) const
+{
+    auto const size = count(piece);
+    if (source.getVertexCount() != size || merged.getVertexCount() < m_offsets[piece + 1]) {
+        return false;
+    }
+
+    sf::Vertex* const target = sf::contiguous_begin(merged) + m_offsets[piece];
+    std::copy_n(sf::contiguous_begin(source), size, target);
+    if (!vertex_array::impl::is_identity(transform)) {
+        vertex_array::impl::transform(target, size, transform);
+    }
+    return true;
+}
@@ -0,0 +1,133 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+    split_chunks()
+
+    This file injects split_chunks() in the `sf` namespace. It cuts the
+    vertices of an `sf::VertexArray` in subranges meant to be handed out
+    to worker threads (a TBB task group, a custom thread pool...).
+
+    Since `VertexArray_iterator` types are random-access iterators,
+    the standard parallel algorithms also accept them directly:
+
+        std::for_each(std::execution::par_unseq, sf::begin(va), sf::end(va), f);
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "VertexArray_iterator.hpp"
+#include "VertexArray_view.hpp"
+
+namespace sf
+{
+std::vector<VertexArray_view<VertexArray_iterator>>
+split_chunks(sf::VertexArray&, std::size_t count);
+
+std::vector<VertexArray_view<VertexArray_const_iterator>>
+split_chunks(sf::VertexArray const&, std::size_t count);
+
+} // namespace sf
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Impl.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace vertex_array::impl
+{
+constexpr std::size_t cache_line_size = 64;
+
+
+
+/**
+ *  Boundaries of at most `count` chunks over `size` vertices starting at
+ *  `address`. Inner boundaries are moved to the nearest vertex starting
+ *  on a cache line, so that two threads never write the same line.
+ *  Empty chunks are dropped.
+ */
+inline std::vector<std::size_t> chunk_boundaries(
+    std::uintptr_t  address,
+    std::size_t     size,
+    std::size_t     count
+){
+    // vertices start on a cache line every `period` vertices, from `phase` on
+    constexpr std::size_t period = cache_line_size / 4;     // 64 / gcd(20, 64)
+    std::size_t phase = 0;
+    while (phase < period && (address + phase * sizeof(sf::Vertex)) % cache_line_size != 0)
+        ++phase;
+    bool const aligned = (phase != period);
+
+    std::vector<std::size_t> bounds {0};
+    count = std::max<std::size_t>(count, 1);
+
+    for (std::size_t k=1; k < count; ++k)
+    {
+        std::size_t bound = size * k / count;
+
+        if (aligned && bound > phase) {
+            bound = phase + (bound - phase + period / 2) / period * period;
+        }
+
+        if (bound > bounds.back() && bound < size)
+            bounds.push_back(bound);
+    }
+
+    if (size > bounds.back())
+        bounds.push_back(size);
+
+    return bounds;
+}
+
+
+
+template <typename Iterator, typename Array>
+std::vector<VertexArray_view<Iterator>> split_chunks(Array& va, std::size_t count)
+{
+    auto const address = reinterpret_cast<std::uintptr_t>(sf::contiguous_begin(va));
+    auto const bounds  = chunk_boundaries(address, va.getVertexCount(), count);
+
+    std::vector<VertexArray_view<Iterator>> chunks;
+    chunks.reserve(bounds.size() - 1);
+
+    for (std::size_t i=1; i < bounds.size(); ++i) {
+        chunks.emplace_back(
+            Iterator{va, bounds[i-1]},
+            Iterator{va, bounds[i]}
+        );
+    }
+    return chunks;
+}
+
+
+
+} // namespace vertex_array::impl
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    split_chunks() implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace sf
+{
+inline std::vector<VertexArray_view<VertexArray_iterator>>
+split_chunks(sf::VertexArray& va, std::size_t count)
+{
+    return vertex_array::impl::split_chunks<VertexArray_iterator>(va, count);
+}
+
+
+
+
+inline std::vector<VertexArray_view<VertexArray_const_iterator>>
+split_chunks(sf::VertexArray const& va, std::size_t count)
+{
+    return vertex_array::impl::split_chunks<VertexArray_const_iterator>(va, count);
+}
+
+
+
+} // namespace sf
@@ -0,0 +1,261 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+    class primitive_iterator
+    class VertexArray_primitive_range
+
+    This file defines iterators walking an `sf::VertexArray` one primitive
+    at a time, and injects primitives() in the `sf` namespace.
+    Dereferencing yields a `std::span<sf::Vertex, N>` whose extent N is
+    the vertex count of the primitive type, known at compile time, so
+    per-primitive loops are fully unrolled:
+
+        for (auto quad : sf::primitives<sf::Quads>(va))
+            for (auto& vertex : quad)
+                vertex.color = sf::Color::Red;
+
+    List types (Points, Lines, Triangles, Quads) advance one whole
+    primitive per step and ignore a trailing incomplete primitive.
+    Strip types (LineStrip, TriangleStrip) advance one vertex per step,
+    yielding every window of N consecutive vertices. TriangleFan
+    primitives are not contiguous and are not supported.
+
+    Requires C++20 (`std::span`).
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#pragma once
+#if __cplusplus > 201703L
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include "VertexArray_iterator.hpp"
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    primitive_traits
+    vertex count of one primitive, and vertex distance between primitives.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+template <sf::PrimitiveType>
+struct primitive_traits;
+
+template <> struct primitive_traits<sf::Points>         { static constexpr std::size_t vertex_count = 1, stride = 1; };
+template <> struct primitive_traits<sf::Lines>          { static constexpr std::size_t vertex_count = 2, stride = 2; };
+template <> struct primitive_traits<sf::LineStrip>      { static constexpr std::size_t vertex_count = 2, stride = 1; };
+template <> struct primitive_traits<sf::Triangles>      { static constexpr std::size_t vertex_count = 3, stride = 3; };
+template <> struct primitive_traits<sf::TriangleStrip>  { static constexpr std::size_t vertex_count = 3, stride = 1; };
+template <> struct primitive_traits<sf::Quads>          { static constexpr std::size_t vertex_count = 4, stride = 4; };
+
+
+
+//* Number of complete primitives in `vertex_count` vertices
+template <sf::PrimitiveType P>
+constexpr std::size_t primitive_count(std::size_t vertex_count) noexcept
+{
+    using traits = primitive_traits<P>;
+    return vertex_count < traits::vertex_count
+        ? 0
+        : (vertex_count - traits::vertex_count) / traits::stride + 1;
+}
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class primitive_iterator
+    random-access iterator over the primitives of an array.
+
+    @param  P           the primitive type
+    @param  Vertex_it   VertexArray_iterator or VertexArray_const_iterator
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+template <sf::PrimitiveType P, typename Vertex_it>
+class primitive_iterator
+{
+    static_assert(
+        std::is_same_v<Vertex_it, VertexArray_iterator>
+        || std::is_same_v<Vertex_it, VertexArray_const_iterator>,
+        "primitive_iterator walks the contiguous (forward) vertex iterators"
+    );
+
+    using traits = primitive_traits<P>;
+    static constexpr auto stride = static_cast<std::ptrdiff_t>(traits::stride);
+
+public:
+    using value_type        = std::span<std::remove_reference_t<typename Vertex_it::reference>, traits::vertex_count>;
+    using difference_type   = std::ptrdiff_t;
+    using reference         = value_type;
+    using pointer           = void;
+    using iterator_category = std::input_iterator_tag;
+    using iterator_concept  = std::random_access_iterator_tag;
+
+private:
+    Vertex_it   m_first;    // first vertex of the current primitive
+
+public:
+    primitive_iterator() noexcept = default;
+    explicit primitive_iterator(Vertex_it first) noexcept : m_first {first} {}
+
+    // need implicit conversion
+    template <typename It = Vertex_it,
+        typename = std::enable_if_t<std::is_same_v<It, VertexArray_iterator>>>
+    operator primitive_iterator<P, VertexArray_const_iterator>() const noexcept {
+        return primitive_iterator<P, VertexArray_const_iterator>{m_first};
+    }
+
+    reference operator*() const noexcept {
+        return reference{std::to_address(m_first), traits::vertex_count};
+    }
+
+    reference operator[](difference_type n) const noexcept {
+        return *(*this + n);
+    }
+
+    // First vertex of the current primitive
+    Vertex_it base() const noexcept { return m_first; }
+
+    primitive_iterator& operator++() noexcept { m_first += stride; return *this; }
+    primitive_iterator& operator--() noexcept { m_first -= stride; return *this; }
+    primitive_iterator  operator++(int) noexcept { auto copy = *this; ++*this; return copy; }
+    primitive_iterator  operator--(int) noexcept { auto copy = *this; --*this; return copy; }
+    primitive_iterator& operator+=(difference_type n) noexcept { m_first += n * stride; return *this; }
+    primitive_iterator& operator-=(difference_type n) noexcept { m_first -= n * stride; return *this; }
+
+    friend primitive_iterator operator+(primitive_iterator it, difference_type n) noexcept
+    {
+        return it += n;
+    }
+
+    friend primitive_iterator operator+(difference_type n, primitive_iterator it) noexcept
+    {
+        return it += n;
+    }
+
+    friend primitive_iterator operator-(primitive_iterator it, difference_type n) noexcept
+    {
+        return it -= n;
+    }
+
+    friend difference_type operator-(primitive_iterator const& lhs, primitive_iterator const& rhs) noexcept
+    {
+        return (lhs.m_first - rhs.m_first) / stride;
+    }
+
+    friend bool operator==(primitive_iterator const& lhs, primitive_iterator const& rhs) noexcept
+    {
+        return lhs.m_first == rhs.m_first;
+    }
+
+    friend auto operator<=>(primitive_iterator const& lhs, primitive_iterator const& rhs) noexcept
+    {
+        return (lhs.m_first - rhs.m_first) <=> 0;
+    }
+
+};
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Iterator aliases, following the four vertex iterator types
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+template <sf::PrimitiveType P>
+using VertexArray_primitive_iterator = primitive_iterator<P, VertexArray_iterator>;
+
+template <sf::PrimitiveType P>
+using VertexArray_const_primitive_iterator = primitive_iterator<P, VertexArray_const_iterator>;
+
+template <sf::PrimitiveType P>
+using VertexArray_reverse_primitive_iterator = std::reverse_iterator<VertexArray_primitive_iterator<P>>;
+
+template <sf::PrimitiveType P>
+using VertexArray_const_reverse_primitive_iterator = std::reverse_iterator<VertexArray_const_primitive_iterator<P>>;
+
+static_assert(std::random_access_iterator<VertexArray_primitive_iterator<sf::Quads>>);
+static_assert(std::random_access_iterator<VertexArray_const_primitive_iterator<sf::Triangles>>);
+static_assert(std::random_access_iterator<VertexArray_reverse_primitive_iterator<sf::Quads>>);
+static_assert(std::random_access_iterator<VertexArray_const_reverse_primitive_iterator<sf::TriangleStrip>>);
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class VertexArray_primitive_range
+    the complete primitives of an array, as returned by sf::primitives().
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+template <sf::PrimitiveType P, typename Vertex_it>
+class VertexArray_primitive_range
+{
+public:
+    using iterator          = primitive_iterator<P, Vertex_it>;
+    using reverse_iterator  = std::reverse_iterator<iterator>;
+
+private:
+    iterator    m_first;
+    iterator    m_last;
+
+public:
+    VertexArray_primitive_range() noexcept = default;
+
+    template <typename Array>
+    explicit VertexArray_primitive_range(Array& va) noexcept
+        : m_first   {Vertex_it{va, 0}}
+        , m_last    {m_first + static_cast<std::ptrdiff_t>(primitive_count<P>(va.getVertexCount()))}
+    {}
+
+    iterator            begin() const noexcept  { return m_first; }
+    iterator            end() const noexcept    { return m_last; }
+    reverse_iterator    rbegin() const noexcept { return reverse_iterator{m_last}; }
+    reverse_iterator    rend() const noexcept   { return reverse_iterator{m_first}; }
+    std::size_t         size() const noexcept   { return static_cast<std::size_t>(m_last - m_first); }
+    bool                empty() const noexcept  { return m_first == m_last; }
+
+    typename iterator::reference operator[](std::size_t idx) const noexcept {
+        return m_first[static_cast<std::ptrdiff_t>(idx)];
+    }
+
+};
+
+template <sf::PrimitiveType P, typename Vertex_it>
+inline constexpr bool std::ranges::enable_view<VertexArray_primitive_range<P, Vertex_it>> = true;
+
+template <sf::PrimitiveType P, typename Vertex_it>
+inline constexpr bool std::ranges::enable_borrowed_range<VertexArray_primitive_range<P, Vertex_it>> = true;
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    primitives()
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace sf
+{
+template <sf::PrimitiveType P>
+VertexArray_primitive_range<P, VertexArray_iterator> primitives(sf::VertexArray& va) noexcept
+{
+    return VertexArray_primitive_range<P, VertexArray_iterator>{va};
+}
+
+
+
+
+template <sf::PrimitiveType P>
+VertexArray_primitive_range<P, VertexArray_const_iterator> primitives(sf::VertexArray const& va) noexcept
+{
+    return VertexArray_primitive_range<P, VertexArray_const_iterator>{va};
+}
+
+
+
+
+template <sf::PrimitiveType P>
+void primitives(sf::VertexArray&&) = delete;
+
+
+
+} // namespace sf
+
+#endif // C++20
@@ -0,0 +1,477 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+    SF_VA_PROFILE_SCOPE()
+    namespace vertex_array::profile
+
+    Builds defining `SF_VA_ITERATOR_PROFILE` count the iterator operations
+    performed on `sf::VertexArray`s, for every thread and every profiled
+    scope:
+
+        traversals      calls to begin(), cbegin(), rbegin() and crbegin()
+        dereferences    `*it` and `it[n]` (not `it->`, which std::to_address()
+                        also calls)
+        steps           ++ and --
+        jumps           +=, -=, + and - (and `jump_distance`, the vertices
+                        skipped by them)
+
+    Operations are attributed to the innermost SF_VA_PROFILE_SCOPE of the
+    thread, or to the "(unscoped)" site:
+
+        void Terrain::update()
+        {
+            SF_VA_PROFILE_SCOPE("terrain");
+            for (auto& vertex : m_vertices) ...
+        }
+
+    Each thread owns a record of counters that only it writes, registered
+    once in a lock-free list. snapshot(), write_json() and
+    write_chrome_trace() read the records from any thread. reset() only
+    starts a new epoch: each thread zeroes its own counters on its next
+    operation, and snapshot() skips the records still in an older epoch.
+
+    Without the switch, SF_VA_PROFILE_SCOPE() expands to nothing and the
+    iterator hooks are empty inline functions.
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#pragma once
+#include <cstddef>
+#ifdef SF_VA_ITERATOR_PROFILE
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#endif
+
+#ifdef SF_VA_ITERATOR_PROFILE
+#define SF_VA_PROFILE_CONCAT_IMPL(a, b) a##b
+#define SF_VA_PROFILE_CONCAT(a, b) SF_VA_PROFILE_CONCAT_IMPL(a, b)
+#define SF_VA_PROFILE_SCOPE(name)                                                       \
+    static vertex_array::profile::Site SF_VA_PROFILE_CONCAT(sf_va_profile_site_, __LINE__) \
+        {name, __FILE__, __LINE__};                                                     \
+    vertex_array::profile::Scope SF_VA_PROFILE_CONCAT(sf_va_profile_scope_, __LINE__)  \
+        {SF_VA_PROFILE_CONCAT(sf_va_profile_site_, __LINE__)}
+#else
+#define SF_VA_PROFILE_SCOPE(name) static_assert(true, "")
+#endif
+
+
+
+
+#ifdef SF_VA_ITERATOR_PROFILE
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Registry
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace vertex_array::profile
+{
+// Site 0 is "(unscoped)"; scopes past this count share the last site, "(other)"
+constexpr std::size_t max_sites = 256;
+
+
+
+//* A profiled scope, declared static by SF_VA_PROFILE_SCOPE()
+class Site
+{
+    char const*     m_name;
+    char const*     m_file;
+    int             m_line;
+    std::size_t     m_id;
+
+public:
+    Site(char const* name, char const* file, int line) noexcept;
+
+    char const*     name() const noexcept { return m_name; }
+    char const*     file() const noexcept { return m_file; }
+    int             line() const noexcept { return m_line; }
+    std::size_t     id() const noexcept { return m_id; }
+
+};
+
+
+
+//* Attributes the iterator operations of this thread to a site until destroyed
+class Scope
+{
+    std::size_t     m_previous;
+
+public:
+    explicit Scope(Site const&) noexcept;
+    ~Scope();
+
+    Scope(Scope const&) = delete;
+    Scope& operator=(Scope const&) = delete;
+
+};
+
+
+
+//* Counters of a site in a thread, at the time of a snapshot()
+struct Stats
+{
+    std::string     site;
+    std::string     file;
+    int             line;
+    std::size_t     thread;
+    std::uint64_t   traversals;
+    std::uint64_t   dereferences;
+    std::uint64_t   steps;
+    std::uint64_t   jumps;
+    std::uint64_t   jump_distance;
+};
+
+
+
+// Non-zero counters of every thread and site, sorted by decreasing dereferences
+std::vector<Stats>  snapshot();
+
+// Zero every counter, from any thread
+void                reset() noexcept;
+
+// {"sites": [{"site": ..., "file": ..., "line": ..., "thread": ..., "dereferences": ...}, ...]}
+void                write_json(std::ostream&);
+
+/**
+ *  Append one Chrome trace counter event per site, totalled over threads
+ *  and stamped with the current time. Events are separated by commas:
+ *  write "[" once, then call this every frame to get a timeline in the
+ *  trace viewer's JSON array format.
+ */
+void                write_chrome_trace(std::ostream&);
+
+} // namespace vertex_array::profile
+#endif
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Impl.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifdef SF_VA_ITERATOR_PROFILE
+namespace vertex_array::profile::impl
+{
+struct Counters
+{
+    std::atomic<std::uint64_t>  traversals      {0};
+    std::atomic<std::uint64_t>  dereferences    {0};
+    std::atomic<std::uint64_t>  steps           {0};
+    std::atomic<std::uint64_t>  jumps           {0};
+    std::atomic<std::uint64_t>  jump_distance   {0};
+};
+
+
+
+struct Thread_record
+{
+    std::array<Counters, max_sites>     counters;
+    std::atomic<std::uint64_t>          epoch   {0};    // of the last reset applied, written by the owner only
+    std::size_t                         thread  = 0;
+    std::size_t                         site    = 0;    // written by the owner only
+    Thread_record*                      next    = nullptr;
+};
+
+
+
+inline std::atomic<Thread_record*>                          thread_records {nullptr};
+inline std::atomic<std::size_t>                             thread_count {0};
+inline std::array<std::atomic<Site const*>, max_sites>      sites {};
+inline std::atomic<std::size_t>                             site_count {1};
+inline std::atomic<std::uint64_t>                           reset_epoch {0};
+
+
+
+// Records outlive their thread, so that the counts of finished workers are kept
+inline Thread_record* register_thread()
+{
+    auto* record = new Thread_record;
+    record->epoch.store(reset_epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    record->thread = thread_count.fetch_add(1, std::memory_order_relaxed);
+    record->next = thread_records.load(std::memory_order_relaxed);
+    while (!thread_records.compare_exchange_weak(record->next, record,
+        std::memory_order_release, std::memory_order_relaxed))
+    {}
+    return record;
+}
+
+
+
+inline Thread_record& this_thread()
+{
+    thread_local Thread_record* const record = register_thread();
+    return *record;
+}
+
+
+
+// Only the owning thread writes a counter: no read-modify-write needed
+inline void add(std::atomic<std::uint64_t>& counter, std::uint64_t n) noexcept
+{
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+
+
+// Zero the counters of the calling thread's record, then publish the epoch they belong to
+inline void apply_reset(Thread_record& record, std::uint64_t epoch) noexcept
+{
+    for (auto& counters : record.counters) {
+        counters.traversals.store(0, std::memory_order_relaxed);
+        counters.dereferences.store(0, std::memory_order_relaxed);
+        counters.steps.store(0, std::memory_order_relaxed);
+        counters.jumps.store(0, std::memory_order_relaxed);
+        counters.jump_distance.store(0, std::memory_order_relaxed);
+    }
+    record.epoch.store(epoch, std::memory_order_release);
+}
+
+
+
+inline Counters& current() noexcept
+{
+    auto& record = this_thread();
+    auto const epoch = reset_epoch.load(std::memory_order_relaxed);
+    if (record.epoch.load(std::memory_order_relaxed) != epoch) {
+        apply_reset(record, epoch);
+    }
+    return record.counters[record.site];
+}
+
+
+
+inline void write_string(std::ostream& os, char const* text)
+{
+    os << '"';
+    for (; *text; ++text) {
+        if (*text == '"' || *text == '\\')
+            os << '\\' << *text;
+        else if (static_cast<unsigned char>(*text) < 0x20)
+            os << ' ';
+        else
+            os << *text;
+    }
+    os << '"';
+}
+
+
+
+inline Stats describe(std::size_t id, std::size_t thread)
+{
+    if (id == 0) {
+        return Stats{"(unscoped)", "", 0, thread, 0, 0, 0, 0, 0};
+    }
+    auto const* site = sites[id].load(std::memory_order_acquire);
+    if (site == nullptr) {
+        return Stats{"(other)", "", 0, thread, 0, 0, 0, 0, 0};
+    }
+    return Stats{site->name(), site->file(), site->line(), thread, 0, 0, 0, 0, 0};
+}
+
+} // namespace vertex_array::profile::impl
+#endif
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Iterator hooks, no-ops without SF_VA_ITERATOR_PROFILE
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace vertex_array::impl
+{
+inline void profile_traversal() noexcept
+{
+#ifdef SF_VA_ITERATOR_PROFILE
+    profile::impl::add(profile::impl::current().traversals, 1);
+#endif
+}
+
+
+
+inline void profile_dereference() noexcept
+{
+#ifdef SF_VA_ITERATOR_PROFILE
+    profile::impl::add(profile::impl::current().dereferences, 1);
+#endif
+}
+
+
+
+inline void profile_step() noexcept
+{
+#ifdef SF_VA_ITERATOR_PROFILE
+    profile::impl::add(profile::impl::current().steps, 1);
+#endif
+}
+
+
+
+inline void profile_jump([[maybe_unused]] std::ptrdiff_t distance) noexcept
+{
+#ifdef SF_VA_ITERATOR_PROFILE
+    auto& counters = profile::impl::current();
+    profile::impl::add(counters.jumps, 1);
+    profile::impl::add(counters.jump_distance,
+        static_cast<std::uint64_t>(distance < 0 ? -distance : distance));
+#endif
+}
+
+} // namespace vertex_array::impl
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Registry implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifdef SF_VA_ITERATOR_PROFILE
+namespace vertex_array::profile
+{
+inline Site::Site(char const* name, char const* file, int line) noexcept
+    : m_name {name}
+    , m_file {file}
+    , m_line {line}
+    , m_id   {std::min(impl::site_count.fetch_add(1, std::memory_order_relaxed), max_sites - 1)}
+{
+    if (m_id < max_sites - 1) {
+        impl::sites[m_id].store(this, std::memory_order_release);
+    }
+}
+
+
+
+
+inline Scope::Scope(Site const& site) noexcept
+    : m_previous {impl::this_thread().site}
+{
+    impl::this_thread().site = site.id();
+}
+
+
+
+
+inline Scope::~Scope()
+{
+    impl::this_thread().site = m_previous;
+}
+
+
+
+
+inline std::vector<Stats> snapshot()
+{
+    std::vector<Stats> stats;
+
+    auto const epoch = impl::reset_epoch.load(std::memory_order_acquire);
+    auto const* record = impl::thread_records.load(std::memory_order_acquire);
+    for (; record != nullptr; record = record->next)
+    {
+        // counters older than the last reset, zeroed on the owner's next operation
+        if (record->epoch.load(std::memory_order_acquire) != epoch) {
+            continue;
+        }
+        for (std::size_t id=0; id < max_sites; ++id)
+        {
+            auto const& counters = record->counters[id];
+            auto const traversals   = counters.traversals.load(std::memory_order_relaxed);
+            auto const dereferences = counters.dereferences.load(std::memory_order_relaxed);
+            auto const steps        = counters.steps.load(std::memory_order_relaxed);
+            auto const jumps        = counters.jumps.load(std::memory_order_relaxed);
+            if (!traversals && !dereferences && !steps && !jumps) {
+                continue;
+            }
+
+            auto row = impl::describe(id, record->thread);
+            row.traversals      = traversals;
+            row.dereferences    = dereferences;
+            row.steps           = steps;
+            row.jumps           = jumps;
+            row.jump_distance   = counters.jump_distance.load(std::memory_order_relaxed);
+            stats.push_back(std::move(row));
+        }
+    }
+
+    std::stable_sort(stats.begin(), stats.end(), [](Stats const& a, Stats const& b) {
+        return a.dereferences > b.dereferences;
+    });
+    return stats;
+}
+
+
+
+
+// Counters are only ever written by their owner, which applies the reset itself
+inline void reset() noexcept
+{
+    impl::reset_epoch.fetch_add(1, std::memory_order_release);
+}
+
+
+
+
+inline void write_json(std::ostream& os)
+{
+    os << "{\"sites\": [";
+    char const* separator = "\n";
+
+    for (auto const& row : snapshot())
+    {
+        os << separator << "  {\"site\": ";
+        impl::write_string(os, row.site.c_str());
+        os << ", \"file\": ";
+        impl::write_string(os, row.file.c_str());
+        os << ", \"line\": "            << row.line
+           << ", \"thread\": "          << row.thread
+           << ", \"traversals\": "      << row.traversals
+           << ", \"dereferences\": "    << row.dereferences
+           << ", \"steps\": "           << row.steps
+           << ", \"jumps\": "           << row.jumps
+           << ", \"jump_distance\": "   << row.jump_distance
+           << "}";
+        separator = ",\n";
+    }
+    os << "\n]}\n";
+}
+
+
+
+
+inline void write_chrome_trace(std::ostream& os)
+{
+    auto const now = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+
+    std::vector<Stats> totals;
+    for (auto const& row : snapshot())
+    {
+        auto total = std::find_if(totals.begin(), totals.end(), [&](Stats const& t) {
+            return t.line == row.line && t.site == row.site && t.file == row.file;
+        });
+        if (total == totals.end()) {
+            totals.push_back(row);
+            continue;
+        }
+        total->traversals   += row.traversals;
+        total->dereferences += row.dereferences;
+        total->steps        += row.steps;
+        total->jumps        += row.jumps;
+    }
+
+    for (auto const& total : totals)
+    {
+        os << "{\"name\": ";
+        impl::write_string(os, total.site.c_str());
+        os << ", \"ph\": \"C\", \"ts\": " << now << ", \"pid\": 1, \"args\": {"
+           << "\"traversals\": "      << total.traversals
+           << ", \"dereferences\": "  << total.dereferences
+           << ", \"steps\": "         << total.steps
+           << ", \"jumps\": "         << total.jumps
+           << "}},\n";
+    }
+}
+
+} // namespace vertex_array::profile
+#endif
@@ -0,0 +1,41 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+    quantize()
+    quantization_step()
+
+    This file holds the 16-bit quantization shared by the quantized file
+    records (VertexArrayFile.hpp) and CompressedVertexArray.hpp: a value
+    of [origin, origin + extent] maps to one of 65536 levels, and back to
+    `origin + level * quantization_step(extent)`.
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace vertex_array::impl
+{
+//* Highest level, mapped to `origin + extent`
+constexpr float quantization_levels = 65535.f;
+
+
+
+inline std::uint16_t quantize(float value, float origin, float extent) noexcept
+{
+    if (extent <= 0.f) {
+        return 0;
+    }
+    auto const q = std::lround((value - origin) / extent * quantization_levels);
+    return static_cast<std::uint16_t>(std::clamp(q, 0L, 65535L));
+}
+
+
+
+//* Distance between two consecutive levels
+inline float quantization_step(float extent) noexcept
+{
+    return extent / quantization_levels;
+}
+
+} // namespace vertex_array::impl
@@ -0,0 +1,571 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+    bounds()
+    centroid()
+    color_histogram()
+    reduce()
+    class VertexArray_reduce_cache
+
+    This file injects the above reductions in the `sf` namespace. They read
+    every vertex of an `sf::VertexArray` (or of a contiguous `sf::Vertex`
+    pointer range) once:
+
+        bounds()            same result as `sf::VertexArray::getBounds()`,
+                            with SSE2 / AVX2 min/max over positions
+        centroid()          mean vertex position
+        color_histogram()   per-channel counts of the vertex colors
+        reduce()            fold of `op` over `projection(vertex)`
+
+    As for `std::transform_reduce`, reduce() first maps every vertex to a
+    `T` with `projection`, then combines values of type `T` with `op`:
+    `op(T, T)` folds the values of a chunk and also merges the results of
+    the chunks. Ranges of more than `reduce_parallel_threshold` vertices
+    are split in cache-line aligned chunks reduced on several threads, so
+    `op` must be associative and commutative, and safe to call
+    concurrently (as for `std::reduce`).
+
+    VertexArray_reduce_cache keeps the last results for an array whose
+    writes all go through the tracking iterators of a
+    `VertexArray_dirty_ranges` (see VertexArray_tracking.hpp). It cannot
+    see writes through `sf::begin()`, `operator[]` or the transform
+    kernels: after those, call invalidate() or the cache returns stale
+    results.
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include "VertexArray_iterator.hpp"
+#include "VertexArray_parallel.hpp"
+#include "VertexArray_tracking.hpp"
+#include "VertexArray_transform.hpp"
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    struct VertexArray_color_histogram
+    number of vertices per value of each color channel.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+struct VertexArray_color_histogram
+{
+    std::array<std::size_t, 256>    r {};
+    std::array<std::size_t, 256>    g {};
+    std::array<std::size_t, 256>    b {};
+    std::array<std::size_t, 256>    a {};
+};
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Reductions
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace sf
+{
+//* Smallest rectangle containing every vertex position, empty if there is no vertex
+sf::FloatRect bounds(sf::VertexArray const&);
+sf::FloatRect bounds(sf::Vertex const* first, sf::Vertex const* last);
+
+//* Mean vertex position, (0, 0) if there is no vertex
+sf::Vector2f centroid(sf::VertexArray const&);
+sf::Vector2f centroid(sf::Vertex const* first, sf::Vertex const* last);
+
+VertexArray_color_histogram color_histogram(sf::VertexArray const&);
+VertexArray_color_histogram color_histogram(sf::Vertex const* first, sf::Vertex const* last);
+
+//* `init` combined by `op(T, T)` with `projection(vertex)` for every vertex, in unspecified order
+template <typename T, typename Op, typename Projection>
+T reduce(sf::VertexArray const&, T init, Op op, Projection projection);
+
+template <typename T, typename Op, typename Projection>
+T reduce(sf::Vertex const* first, sf::Vertex const* last, T init, Op op, Projection projection);
+
+} // namespace sf
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class VertexArray_reduce_cache
+    last reduction results of one array, recomputed only after it changed.
+
+    An array counts as changed when the generation of its dirty ranges,
+    its vertex count or its storage address changed. Nothing else is
+    checked, so the cache is only correct for arrays written through
+    tracking iterators: any other write (plain iterators, `va[i]`,
+    apply_transform() and the other kernels) must be followed by a call
+    to invalidate().
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+class VertexArray_reduce_cache
+{
+    struct Stamp
+    {
+        std::uint64_t       generation = 0;
+        sf::Vertex const*   data = nullptr;
+        std::size_t         count = 0;
+        bool                valid = false;
+    };
+
+    sf::VertexArray const*              m_array;
+    VertexArray_dirty_ranges const*     m_dirty;
+
+    sf::FloatRect                       m_bounds;
+    sf::Vector2f                        m_centroid;
+    VertexArray_color_histogram         m_histogram;
+    Stamp                               m_bounds_stamp;
+    Stamp                               m_centroid_stamp;
+    Stamp                               m_histogram_stamp;
+
+public:
+    VertexArray_reduce_cache(sf::VertexArray const&, VertexArray_dirty_ranges const&) noexcept;
+
+    sf::FloatRect const&                bounds();
+    sf::Vector2f const&                 centroid();
+    VertexArray_color_histogram const&  color_histogram();
+
+    void                                invalidate() noexcept;
+
+private:
+    Stamp                               current() const noexcept;
+    static bool                         fresh(Stamp const& cached, Stamp const& now) noexcept;
+
+};
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Impl.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace vertex_array::impl
+{
+//* Ranges with more vertices are reduced on several threads
+constexpr std::size_t reduce_parallel_threshold = 1 << 16;
+
+
+
+//* Number of threads worth starting for `count` vertices
+inline std::size_t reduce_threads(std::size_t count) noexcept
+{
+    static std::size_t const hardware = std::max(std::thread::hardware_concurrency(), 1u);
+    return std::min(hardware, count / reduce_parallel_threshold + 1);
+}
+
+
+
+/**
+ *  Reduce `count` vertices from `first` with at most `threads` threads.
+ *  `chunk(first, count)` reduces a non-empty chunk, `combine` folds the
+ *  chunk results into `init`.
+ */
+template <typename T, typename Chunk_fn, typename Combine>
+T parallel_reduce(
+    sf::Vertex const*   first,
+    std::size_t         count,
+    std::size_t         threads,
+    T                   init,
+    Chunk_fn            chunk,
+    Combine             combine
+){
+    if (count == 0) {
+        return init;
+    }
+    if (threads <= 1) {
+        return combine(std::move(init), chunk(first, count));
+    }
+
+    auto const address = reinterpret_cast<std::uintptr_t>(first);
+    auto const bounds  = chunk_boundaries(address, count, threads);
+
+    if (bounds.size() <= 2) {
+        return combine(std::move(init), chunk(first, count));
+    }
+
+    std::vector<std::optional<T>> partial (bounds.size() - 1);
+    std::vector<std::thread> workers;
+    workers.reserve(partial.size());
+
+    for (std::size_t k=1; k < bounds.size(); ++k) {
+        workers.emplace_back([&, k]{
+            partial[k-1].emplace(chunk(first + bounds[k-1], bounds[k] - bounds[k-1]));
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+
+    for (auto& result : partial)
+        init = combine(std::move(init), std::move(*result));
+    return init;
+}
+
+
+
+//* Running min/max of positions
+struct Position_bounds
+{
+    float   left   = std::numeric_limits<float>::max();
+    float   top    = std::numeric_limits<float>::max();
+    float   right  = std::numeric_limits<float>::lowest();
+    float   bottom = std::numeric_limits<float>::lowest();
+};
+
+
+
+inline Position_bounds merge_bounds(Position_bounds a, Position_bounds const& b) noexcept
+{
+    a.left   = std::min(a.left, b.left);
+    a.top    = std::min(a.top, b.top);
+    a.right  = std::max(a.right, b.right);
+    a.bottom = std::max(a.bottom, b.bottom);
+    return a;
+}
+
+
+
+inline Position_bounds bounds_scalar(sf::Vertex const* first, std::size_t count, Position_bounds b)
+noexcept
+{
+    for (std::size_t i=0; i < count; ++i) {
+        auto const& position = first[i].position;
+        b.left   = std::min(b.left, position.x);
+        b.top    = std::min(b.top, position.y);
+        b.right  = std::max(b.right, position.x);
+        b.bottom = std::max(b.bottom, position.y);
+    }
+    return b;
+}
+
+
+
+#ifdef SF_VA_SIMD_X86
+// Fold lanes (min x, min y, min x, min y) and (max x, max y, max x, max y)
+__attribute__((target("sse2")))
+inline Position_bounds fold_bounds_sse2(__m128 lo, __m128 hi) noexcept
+{
+    lo = _mm_min_ps(lo, _mm_movehl_ps(lo, lo));
+    hi = _mm_max_ps(hi, _mm_movehl_ps(hi, hi));
+
+    alignas(16) float min[4], max[4];
+    _mm_store_ps(min, lo);
+    _mm_store_ps(max, hi);
+    return {min[0], min[1], max[0], max[1]};
+}
+
+
+
+__attribute__((target("sse2")))
+inline Position_bounds bounds_sse2(sf::Vertex const* first, std::size_t count) noexcept
+{
+    Position_bounds const b;
+    __m128 lo = _mm_setr_ps(b.left, b.top, b.left, b.top);
+    __m128 hi = _mm_setr_ps(b.right, b.bottom, b.right, b.bottom);
+    std::size_t i = 0;
+
+    for (; i + 2 <= count; i += 2) {
+        auto const* p = reinterpret_cast<__m64 const*>(vec2_field<position_offset>(first + i));
+        auto const* q = reinterpret_cast<__m64 const*>(vec2_field<position_offset>(first + i + 1));
+        __m128 const v = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), p), q);
+        lo = _mm_min_ps(lo, v);
+        hi = _mm_max_ps(hi, v);
+    }
+    return bounds_scalar(first + i, count - i, fold_bounds_sse2(lo, hi));
+}
+
+
+
+__attribute__((target("avx2")))
+inline Position_bounds bounds_avx2(sf::Vertex const* first, std::size_t count) noexcept
+{
+    Position_bounds const b;
+    __m256 lo = _mm256_setr_ps(b.left, b.top, b.left, b.top, b.left, b.top, b.left, b.top);
+    __m256 hi = _mm256_setr_ps(b.right, b.bottom, b.right, b.bottom, b.right, b.bottom, b.right, b.bottom);
+    std::size_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m256 const v = load_vec2x4_avx2<position_offset>(first + i);
+        lo = _mm256_min_ps(lo, v);
+        hi = _mm256_max_ps(hi, v);
+    }
+
+    __m128 const lo4 = _mm_min_ps(_mm256_castps256_ps128(lo), _mm256_extractf128_ps(lo, 1));
+    __m128 const hi4 = _mm_max_ps(_mm256_castps256_ps128(hi), _mm256_extractf128_ps(hi, 1));
+    return bounds_scalar(first + i, count - i, fold_bounds_sse2(lo4, hi4));
+}
+#endif // SF_VA_SIMD_X86
+
+
+
+inline Position_bounds bounds(sf::Vertex const* first, std::size_t count) noexcept
+{
+#ifdef SF_VA_SIMD_X86
+    switch (runtime_isa()) {
+        case Isa::avx2: return bounds_avx2(first, count);
+        case Isa::sse2: return bounds_sse2(first, count);
+        case Isa::scalar: break;
+    }
+#endif
+    return bounds_scalar(first, count, Position_bounds{});
+}
+
+
+
+inline std::pair<double, double> position_sum(sf::Vertex const* first, std::size_t count) noexcept
+{
+    double x = 0.0, y = 0.0;
+    for (std::size_t i=0; i < count; ++i) {
+        x += first[i].position.x;
+        y += first[i].position.y;
+    }
+    return {x, y};
+}
+
+
+
+inline VertexArray_color_histogram histogram(sf::Vertex const* first, std::size_t count) noexcept
+{
+    VertexArray_color_histogram histogram;
+    for (std::size_t i=0; i < count; ++i) {
+        ++histogram.r[first[i].color.r];
+        ++histogram.g[first[i].color.g];
+        ++histogram.b[first[i].color.b];
+        ++histogram.a[first[i].color.a];
+    }
+    return histogram;
+}
+
+
+
+inline VertexArray_color_histogram merge_histograms(
+    VertexArray_color_histogram         a,
+    VertexArray_color_histogram const&  b
+) noexcept {
+    for (std::size_t v=0; v < 256; ++v) {
+        a.r[v] += b.r[v];
+        a.g[v] += b.g[v];
+        a.b[v] += b.b[v];
+        a.a[v] += b.a[v];
+    }
+    return a;
+}
+
+
+
+} // namespace vertex_array::impl
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Reductions implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace sf
+{
+inline sf::FloatRect bounds(sf::VertexArray const& va)
+{
+    return bounds(sf::contiguous_begin(va), sf::contiguous_end(va));
+}
+
+
+
+
+inline sf::FloatRect bounds(sf::Vertex const* first, sf::Vertex const* last)
+{
+    using namespace vertex_array::impl;
+    auto const count = static_cast<std::size_t>(last - first);
+
+    if (count == 0) {
+        return sf::FloatRect{};
+    }
+
+    auto const b = parallel_reduce(first, count, reduce_threads(count), Position_bounds{},
+        [](sf::Vertex const* chunk, std::size_t size) { return vertex_array::impl::bounds(chunk, size); },
+        merge_bounds
+    );
+    return sf::FloatRect{b.left, b.top, b.right - b.left, b.bottom - b.top};
+}
+
+
+
+
+inline sf::Vector2f centroid(sf::VertexArray const& va)
+{
+    return centroid(sf::contiguous_begin(va), sf::contiguous_end(va));
+}
+
+
+
+
+inline sf::Vector2f centroid(sf::Vertex const* first, sf::Vertex const* last)
+{
+    using namespace vertex_array::impl;
+    auto const count = static_cast<std::size_t>(last - first);
+
+    if (count == 0) {
+        return sf::Vector2f{};
+    }
+
+    auto const sum = parallel_reduce(first, count, reduce_threads(count), std::pair<double, double>{},
+        position_sum,
+        [](std::pair<double, double> a, std::pair<double, double> const& b) {
+            return std::pair<double, double>{a.first + b.first, a.second + b.second};
+        }
+    );
+    return sf::Vector2f{
+        static_cast<float>(sum.first / static_cast<double>(count)),
+        static_cast<float>(sum.second / static_cast<double>(count))
+    };
+}
+
+
+
+
+inline VertexArray_color_histogram color_histogram(sf::VertexArray const& va)
+{
+    return color_histogram(sf::contiguous_begin(va), sf::contiguous_end(va));
+}
+
+
+
+
+inline VertexArray_color_histogram color_histogram(sf::Vertex const* first, sf::Vertex const* last)
+{
+    using namespace vertex_array::impl;
+    auto const count = static_cast<std::size_t>(last - first);
+
+    return parallel_reduce(first, count, reduce_threads(count), VertexArray_color_histogram{},
+        histogram, merge_histograms
+    );
+}
+
+
+
+
+template <typename T, typename Op, typename Projection>
+T reduce(sf::VertexArray const& va, T init, Op op, Projection projection)
+{
+    return reduce(sf::contiguous_begin(va), sf::contiguous_end(va),
+        std::move(init), std::move(op), std::move(projection));
+}
+
+
+
+
+template <typename T, typename Op, typename Projection>
+T reduce(sf::Vertex const* first, sf::Vertex const* last, T init, Op op, Projection projection)
+{
+    using namespace vertex_array::impl;
+    static_assert(std::is_convertible_v<std::invoke_result_t<Projection&, sf::Vertex const&>, T>,
+        "projection maps a vertex to a T");
+    static_assert(std::is_convertible_v<std::invoke_result_t<Op&, T, T>, T>,
+        "op combines two T into a T");
+    auto const count = static_cast<std::size_t>(last - first);
+
+    auto const chunk = [&](sf::Vertex const* vertex, std::size_t size) {
+        T acc (projection(vertex[0]));
+        for (std::size_t i=1; i < size; ++i)
+            acc = op(std::move(acc), projection(vertex[i]));
+        return acc;
+    };
+    return parallel_reduce(first, count, reduce_threads(count), std::move(init), chunk, op);
+}
+
+
+
+} // namespace sf
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    VertexArray_reduce_cache implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+inline VertexArray_reduce_cache::VertexArray_reduce_cache(
+    sf::VertexArray const&          va,
+    VertexArray_dirty_ranges const& dirty
+) noexcept
+    : m_array   {&va}
+    , m_dirty   {&dirty}
+{
+}
+
+
+
+
+inline sf::FloatRect const& VertexArray_reduce_cache::bounds()
+{
+    auto const now = current();
+    if (!fresh(m_bounds_stamp, now)) {
+        m_bounds = sf::bounds(*m_array);
+        m_bounds_stamp = now;
+    }
+    return m_bounds;
+}
+
+
+
+
+inline sf::Vector2f const& VertexArray_reduce_cache::centroid()
+{
+    auto const now = current();
+    if (!fresh(m_centroid_stamp, now)) {
+        m_centroid = sf::centroid(*m_array);
+        m_centroid_stamp = now;
+    }
+    return m_centroid;
+}
+
+
+
+
+inline VertexArray_color_histogram const& VertexArray_reduce_cache::color_histogram()
+{
+    auto const now = current();
+    if (!fresh(m_histogram_stamp, now)) {
+        m_histogram = sf::color_histogram(*m_array);
+        m_histogram_stamp = now;
+    }
+    return m_histogram;
+}
+
+
+
+
+inline void VertexArray_reduce_cache::invalidate() noexcept
+{
+    m_bounds_stamp.valid = false;
+    m_centroid_stamp.valid = false;
+    m_histogram_stamp.valid = false;
+}
+
+
+
+
+inline auto VertexArray_reduce_cache::current() const noexcept -> Stamp
+{
+    return Stamp{
+        m_dirty->generation(),
+        sf::contiguous_begin(*m_array),
+        m_array->getVertexCount(),
+        true
+    };
+}
+
+
+
+
+inline bool VertexArray_reduce_cache::fresh(Stamp const& cached, Stamp const& now) noexcept
+{
+    return cached.valid
+        && cached.generation == now.generation
+        && cached.data == now.data
+        && cached.count == now.count;
+}
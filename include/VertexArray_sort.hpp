@@ -0,0 +1,233 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+    class VertexArray_primitive_sorter
+    sort_primitives()
+
+    This file defines a stable LSD radix sort of the primitives of an
+    `sf::VertexArray` by an unsigned integer key (texture page, depth...),
+    and injects sort_primitives() in the `sf` namespace:
+
+        sf::sort_primitives(sprites, [](sf::Vertex const* quad) {
+            return page_of(quad[0].texCoords) << 16 | depth_of(quad[0]);
+        });
+
+    The key function receives the first vertex of each primitive. Points,
+    Lines, Triangles and Quads are sorted as units of 1, 2, 3 and 4
+    vertices; a trailing incomplete primitive stays at the end. Strip and
+    fan arrays share vertices between primitives and cannot be reordered.
+
+    Keys are computed along with their byte histograms in one pass, on
+    several threads for large arrays. Passes over a byte equal in every
+    key are skipped, so small keys in a 64-bit type cost no extra pass.
+    A sorter kept across frames reuses its buffers.
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include "VertexArray_iterator.hpp"
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class VertexArray_primitive_sorter
+
+    @param  Key     unsigned integer type of the keys, up to 64 bits
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+template <typename Key>
+class VertexArray_primitive_sorter
+{
+    static_assert(std::is_unsigned_v<Key> && sizeof(Key) <= 8,
+        "primitives are sorted by unsigned integer keys of up to 64 bits");
+
+public:
+    // Arrays with more primitives have their keys computed on several threads
+    static constexpr std::size_t parallel_threshold = 1 << 16;
+
+private:
+    static constexpr std::size_t key_bytes = sizeof(Key);
+
+    struct Entry
+    {
+        Key             key;
+        std::uint32_t   primitive;
+    };
+
+    using Histograms = std::array<std::array<std::size_t, 256>, key_bytes>;
+
+    std::vector<Entry>          m_entries;
+    std::vector<Entry>          m_scratch;
+    std::vector<sf::Vertex>     m_vertices;
+
+public:
+    /**
+     *  Stable sort of the primitives of `va` by `key(first_vertex)`.
+     *
+     *  @return false if the primitive type cannot be reordered
+     */
+    template <typename Key_fn>
+    bool sort(sf::VertexArray& va, Key_fn key);
+
+private:
+    template <typename Key_fn>
+    void compute_keys(sf::Vertex const*, std::size_t per_primitive, std::size_t count,
+        Key_fn& key, Histograms&);
+
+};
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    sort_primitives()
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace sf
+{
+/**
+ *  Stable sort of the primitives of `va` by `key(first_vertex)`, which
+ *  returns an unsigned integer. Use a VertexArray_primitive_sorter to
+ *  keep the buffers from one call to the next.
+ *
+ *  @return false if the primitive type cannot be reordered
+ */
+template <typename Key_fn>
+bool sort_primitives(sf::VertexArray& va, Key_fn key)
+{
+    using Key = std::invoke_result_t<Key_fn&, sf::Vertex const*>;
+    VertexArray_primitive_sorter<Key> sorter;
+    return sorter.sort(va, key);
+}
+
+} // namespace sf
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Impl.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace vertex_array::impl
+{
+//* Vertices per independent primitive, 0 when primitives share vertices
+inline std::size_t sortable_primitive_size(sf::PrimitiveType type) noexcept
+{
+    switch (type) {
+        case sf::Points:    return 1;
+        case sf::Lines:     return 2;
+        case sf::Triangles: return 3;
+        case sf::Quads:     return 4;
+        default:            return 0;
+    }
+}
+
+} // namespace vertex_array::impl
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    VertexArray_primitive_sorter implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+template <typename Key>
+template <typename Key_fn>
+bool VertexArray_primitive_sorter<Key>::sort(sf::VertexArray& va, Key_fn key)
+{
+    auto const per_primitive = vertex_array::impl::sortable_primitive_size(va.getPrimitiveType());
+    if (per_primitive == 0) {
+        return false;
+    }
+
+    auto const count = va.getVertexCount() / per_primitive;
+    if (count < 2) {
+        return true;
+    }
+
+    sf::Vertex* const vertices = sf::contiguous_begin(va);
+    Histograms histograms {};
+    compute_keys(vertices, per_primitive, count, key, histograms);
+
+    // one counting pass per byte that differs between keys
+    m_scratch.resize(count);
+    for (std::size_t byte=0; byte < key_bytes; ++byte)
+    {
+        auto& histogram = histograms[byte];
+        if (std::find(histogram.begin(), histogram.end(), count) != histogram.end()) {
+            continue;
+        }
+
+        std::size_t offset = 0;
+        for (auto& bucket : histogram) {
+            auto const size = bucket;
+            bucket = offset;
+            offset += size;
+        }
+
+        auto const shift = 8 * byte;
+        for (auto const& entry : m_entries)
+            m_scratch[histogram[(entry.key >> shift) & 0xFF]++] = entry;
+        m_entries.swap(m_scratch);
+    }
+
+    // move whole primitives to their rank
+    m_vertices.resize(count * per_primitive);
+    for (std::size_t i=0; i < count; ++i) {
+        std::copy_n(
+            vertices + m_entries[i].primitive * per_primitive,
+            per_primitive,
+            m_vertices.data() + i * per_primitive
+        );
+    }
+    std::copy(m_vertices.begin(), m_vertices.end(), vertices);
+    return true;
+}
+
+
+
+
+template <typename Key>
+template <typename Key_fn>
+void VertexArray_primitive_sorter<Key>::compute_keys(
+    sf::Vertex const*   vertices,
+    std::size_t         per_primitive,
+    std::size_t         count,
+    Key_fn&             key,
+    Histograms&         histograms
+){
+    m_entries.resize(count);
+
+    auto const work = [&](std::size_t first, std::size_t last, Histograms& local) {
+        for (std::size_t i=first; i < last; ++i) {
+            Key const k = key(vertices + i * per_primitive);
+            m_entries[i] = Entry{k, static_cast<std::uint32_t>(i)};
+            for (std::size_t byte=0; byte < key_bytes; ++byte)
+                ++local[byte][(k >> (8 * byte)) & 0xFF];
+        }
+    };
+
+    auto const hardware = std::max(std::thread::hardware_concurrency(), 1u);
+    auto const threads = std::min<std::size_t>(hardware, count / parallel_threshold + 1);
+
+    if (threads <= 1) {
+        work(0, count, histograms);
+        return;
+    }
+
+    std::vector<Histograms> partial (threads, Histograms{});
+    std::vector<std::thread> workers;
+    for (std::size_t t=0; t < threads; ++t)
+        workers.emplace_back(work, count * t / threads, count * (t+1) / threads, std::ref(partial[t]));
+    for (auto& worker : workers)
+        worker.join();
+
+    for (auto const& local : partial)
+        for (std::size_t byte=0; byte < key_bytes; ++byte)
+            for (std::size_t v=0; v < 256; ++v)
+                histograms[byte][v] += local[byte][v];
+}
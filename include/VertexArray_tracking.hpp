@@ -0,0 +1,519 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+    class VertexArray_dirty_ranges
+    class VertexArray_tracking_iterator
+
+    This file defines an interval set of modified vertex indices, and an
+    iterator over an `sf::VertexArray` that records every write in it.
+    It injects tracking_begin(), tracking_end() and upload() in the `sf`
+    namespace: upload() feeds a vertex buffer with the modified spans
+    only, through `update(vertices, count, offset)`.
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include "VertexArray_iterator.hpp"
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class VertexArray_dirty_ranges
+    set of disjoint, non-adjacent, half-open index ranges.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+class VertexArray_dirty_ranges
+{
+public:
+    using container = std::map<std::size_t, std::size_t>;   // first -> last
+
+private:
+    container       m_ranges;
+    std::uint64_t   m_generation = 0;
+
+public:
+    void                add(std::size_t first, std::size_t last);
+    void                add(std::size_t index);
+    void                clear() noexcept;
+
+    bool                empty() const noexcept;
+    std::size_t         vertex_count() const noexcept;
+    container const&    ranges() const noexcept;
+
+    // Incremented by every recorded write, lets callers detect changes
+    std::uint64_t       generation() const noexcept;
+
+};
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class VertexArray_write_proxy
+    returned by VertexArray_tracking_iterator::operator*().
+    Reads go through unrecorded, assigning a vertex records its index.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+class VertexArray_write_proxy
+{
+    sf::Vertex&                 m_vertex;
+    VertexArray_dirty_ranges&   m_dirty;
+    std::size_t                 m_index;
+
+public:
+    VertexArray_write_proxy(sf::Vertex&, VertexArray_dirty_ranges&, std::size_t) noexcept;
+
+    operator sf::Vertex const&() const noexcept;
+    sf::Vertex const&               get() const noexcept;
+
+    VertexArray_write_proxy(VertexArray_write_proxy const&) noexcept = default;
+
+    VertexArray_write_proxy const&  operator=(sf::Vertex const&) const;
+
+    // Copy the vertex of another proxy, as in `*a = *b`, records the index
+    VertexArray_write_proxy const&  operator=(VertexArray_write_proxy const&) const;
+
+    // Mutable access to the vertex fields, records the index
+    sf::Vertex&                     edit() const;
+
+    // Swap the vertices, as std::iter_swap does, records both indices
+    friend void swap(VertexArray_write_proxy lhs, VertexArray_write_proxy rhs)
+    {
+        lhs.m_dirty.add(lhs.m_index);
+        rhs.m_dirty.add(rhs.m_index);
+        std::swap(lhs.m_vertex, rhs.m_vertex);
+    }
+
+};
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class VertexArray_tracking_iterator
+    random-access iterator recording writes in a VertexArray_dirty_ranges.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+class VertexArray_tracking_iterator
+{
+public:
+    using value_type        = sf::Vertex;
+    using difference_type   = std::ptrdiff_t;
+    using reference         = VertexArray_write_proxy;
+    using pointer           = sf::Vertex const*;
+    using iterator_category = std::random_access_iterator_tag;
+
+private:
+    sf::VertexArray*            m_array = nullptr;
+    VertexArray_dirty_ranges*   m_dirty = nullptr;
+    std::size_t                 m_index = 0;
+
+public:
+    VertexArray_tracking_iterator() noexcept = default;
+    VertexArray_tracking_iterator(sf::VertexArray&, VertexArray_dirty_ranges&, std::size_t) noexcept;
+
+    reference                       operator*() const noexcept;
+    reference                       operator[](difference_type) const noexcept;
+
+    // Read-only member access, never recorded
+    pointer                         operator->() const noexcept;
+
+    VertexArray_tracking_iterator&  operator++() noexcept;
+    VertexArray_tracking_iterator   operator++(int) noexcept;
+    VertexArray_tracking_iterator&  operator--() noexcept;
+    VertexArray_tracking_iterator   operator--(int) noexcept;
+    VertexArray_tracking_iterator&  operator+=(difference_type) noexcept;
+    VertexArray_tracking_iterator&  operator-=(difference_type) noexcept;
+
+    // Position in the array, whatever the tracking
+    VertexArray_iterator            base() const noexcept;
+
+    friend VertexArray_tracking_iterator operator+(VertexArray_tracking_iterator it, difference_type n) noexcept
+    {
+        return it += n;
+    }
+
+    friend VertexArray_tracking_iterator operator+(difference_type n, VertexArray_tracking_iterator it) noexcept
+    {
+        return it += n;
+    }
+
+    friend VertexArray_tracking_iterator operator-(VertexArray_tracking_iterator it, difference_type n) noexcept
+    {
+        return it -= n;
+    }
+
+    friend difference_type operator-(VertexArray_tracking_iterator const& lhs, VertexArray_tracking_iterator const& rhs) noexcept
+    {
+        return static_cast<difference_type>(lhs.m_index)
+             - static_cast<difference_type>(rhs.m_index);
+    }
+
+    friend bool operator==(VertexArray_tracking_iterator const& lhs, VertexArray_tracking_iterator const& rhs) noexcept
+    {
+        return lhs.m_array == rhs.m_array
+            && lhs.m_index == rhs.m_index;
+    }
+
+    friend bool operator!=(VertexArray_tracking_iterator const& lhs, VertexArray_tracking_iterator const& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    friend bool operator<(VertexArray_tracking_iterator const& lhs, VertexArray_tracking_iterator const& rhs) noexcept
+    {
+        return lhs.m_index < rhs.m_index;
+    }
+
+    friend bool operator>(VertexArray_tracking_iterator const& lhs, VertexArray_tracking_iterator const& rhs) noexcept
+    {
+        return lhs.m_index > rhs.m_index;
+    }
+
+    friend bool operator<=(VertexArray_tracking_iterator const& lhs, VertexArray_tracking_iterator const& rhs) noexcept
+    {
+        return lhs.m_index <= rhs.m_index;
+    }
+
+    friend bool operator>=(VertexArray_tracking_iterator const& lhs, VertexArray_tracking_iterator const& rhs) noexcept
+    {
+        return lhs.m_index >= rhs.m_index;
+    }
+
+};
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    tracking_begin(), tracking_end() and upload()
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace sf
+{
+VertexArray_tracking_iterator   tracking_begin(sf::VertexArray&, VertexArray_dirty_ranges&) noexcept;
+VertexArray_tracking_iterator   tracking_end(sf::VertexArray&, VertexArray_dirty_ranges&) noexcept;
+
+/**
+ *  Call `buffer.update(vertices, count, offset)` once per dirty range,
+ *  then clear the ranges. `Buffer` is typically `sf::VertexBuffer`,
+ *  already sized for the whole array. Ranges are clamped to the vertex
+ *  count, so writes to vertices removed since are dropped.
+ *
+ *  @return false if an update failed; remaining ranges are kept
+ */
+template <typename Buffer>
+bool upload(Buffer& buffer, sf::VertexArray const&, VertexArray_dirty_ranges&);
+
+
+
+
+inline VertexArray_tracking_iterator tracking_begin(
+    sf::VertexArray& va, VertexArray_dirty_ranges& dirty
+) noexcept
+{
+    return {va, dirty, 0};
+}
+
+
+
+
+inline VertexArray_tracking_iterator tracking_end(
+    sf::VertexArray& va, VertexArray_dirty_ranges& dirty
+) noexcept
+{
+    return {va, dirty, va.getVertexCount()};
+}
+
+
+
+
+template <typename Buffer>
+bool upload(Buffer& buffer, sf::VertexArray const& va, VertexArray_dirty_ranges& dirty)
+{
+    VertexArray_dirty_ranges failed;
+
+    for (auto const& [first, dirty_last] : dirty.ranges())
+    {
+        // writes past the end of an array that shrank since have nothing to upload
+        auto const last = std::min(dirty_last, va.getVertexCount());
+        if (first >= last) {
+            continue;
+        }
+        if (!buffer.update(&va[first], last - first, static_cast<unsigned int>(first))) {
+            failed.add(first, last);
+        }
+    }
+
+    dirty.clear();
+    for (auto const& [first, last] : failed.ranges())
+        dirty.add(first, last);
+
+    return failed.empty();
+}
+
+
+
+} // namespace sf
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    VertexArray_dirty_ranges implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+inline void VertexArray_dirty_ranges::add(std::size_t first, std::size_t last)
+{
+    if (first >= last) {
+        return;
+    }
+    ++m_generation;
+
+    // Ranges are grown in place, so that sequential writes allocate nothing:
+    // only a new disjoint range allocates, only absorbed ranges are freed
+    auto next = m_ranges.upper_bound(first);
+    auto grown = m_ranges.end();
+
+    if (next != m_ranges.begin() && std::prev(next)->second >= first) {
+        // the range starting at or before `first` touches it: widen it
+        grown = std::prev(next);
+        grown->second = std::max(grown->second, last);
+    }
+    else if (next != m_ranges.end() && next->first <= last) {
+        // the range after `first` touches it: its key moves down, keep its node
+        auto node = m_ranges.extract(next++);
+        node.key() = first;
+        node.mapped() = std::max(node.mapped(), last);
+        grown = m_ranges.insert(next, std::move(node));
+    }
+    else {
+        m_ranges.emplace_hint(next, first, last);
+        return;
+    }
+
+    // swallow the following ranges overlapping or adjacent to the grown one
+    while (next != m_ranges.end() && next->first <= grown->second) {
+        grown->second = std::max(grown->second, next->second);
+        next = m_ranges.erase(next);
+    }
+}
+
+
+
+
+inline void VertexArray_dirty_ranges::add(std::size_t index)
+{
+    add(index, index+1);
+}
+
+
+
+
+inline void VertexArray_dirty_ranges::clear() noexcept
+{
+    m_ranges.clear();
+}
+
+
+
+
+inline bool VertexArray_dirty_ranges::empty() const noexcept
+{
+    return m_ranges.empty();
+}
+
+
+
+
+inline std::size_t VertexArray_dirty_ranges::vertex_count() const noexcept
+{
+    std::size_t count = 0;
+    for (auto const& [first, last] : m_ranges)
+        count += last - first;
+    return count;
+}
+
+
+
+
+inline auto VertexArray_dirty_ranges::ranges() const noexcept -> container const&
+{
+    return m_ranges;
+}
+
+
+
+
+inline std::uint64_t VertexArray_dirty_ranges::generation() const noexcept
+{
+    return m_generation;
+}
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    VertexArray_write_proxy implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+inline VertexArray_write_proxy::VertexArray_write_proxy(
+    sf::Vertex&                 vertex,
+    VertexArray_dirty_ranges&   dirty,
+    std::size_t                 index
+) noexcept
+    : m_vertex  {vertex}
+    , m_dirty   {dirty}
+    , m_index   {index}
+{
+}
+
+
+
+
+inline VertexArray_write_proxy::operator sf::Vertex const&() const noexcept
+{
+    return m_vertex;
+}
+
+
+
+
+inline sf::Vertex const& VertexArray_write_proxy::get() const noexcept
+{
+    return m_vertex;
+}
+
+
+
+
+inline auto VertexArray_write_proxy::operator=(sf::Vertex const& vertex) const
+    -> VertexArray_write_proxy const&
+{
+    m_dirty.add(m_index);
+    m_vertex = vertex;
+    return *this;
+}
+
+
+
+
+inline auto VertexArray_write_proxy::operator=(VertexArray_write_proxy const& other) const
+    -> VertexArray_write_proxy const&
+{
+    return *this = other.get();
+}
+
+
+
+
+inline sf::Vertex& VertexArray_write_proxy::edit() const
+{
+    m_dirty.add(m_index);
+    return m_vertex;
+}
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    VertexArray_tracking_iterator implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+inline VertexArray_tracking_iterator::VertexArray_tracking_iterator(
+    sf::VertexArray&            array,
+    VertexArray_dirty_ranges&   dirty,
+    std::size_t                 index
+) noexcept
+    : m_array   {&array}
+    , m_dirty   {&dirty}
+    , m_index   {index}
+{
+}
+
+
+
+
+inline auto VertexArray_tracking_iterator::operator*() const noexcept -> reference
+{
+    return {(*m_array)[m_index], *m_dirty, m_index};
+}
+
+
+
+
+inline auto VertexArray_tracking_iterator::operator[](difference_type n) const noexcept
+    -> reference
+{
+    return *(*this + n);
+}
+
+
+
+
+inline auto VertexArray_tracking_iterator::operator->() const noexcept -> pointer
+{
+    return &(*m_array)[m_index];
+}
+
+
+
+
+inline VertexArray_tracking_iterator& VertexArray_tracking_iterator::operator++() noexcept
+{
+    ++m_index;
+    return *this;
+}
+
+
+
+
+inline VertexArray_tracking_iterator VertexArray_tracking_iterator::operator++(int) noexcept
+{
+    auto copy = *this;
+    ++m_index;
+    return copy;
+}
+
+
+
+
+inline VertexArray_tracking_iterator& VertexArray_tracking_iterator::operator--() noexcept
+{
+    --m_index;
+    return *this;
+}
+
+
+
+
+inline VertexArray_tracking_iterator VertexArray_tracking_iterator::operator--(int) noexcept
+{
+    auto copy = *this;
+    --m_index;
+    return copy;
+}
+
+
+
+
+inline VertexArray_tracking_iterator&
+VertexArray_tracking_iterator::operator+=(difference_type n) noexcept
+{
+    m_index += n;
+    return *this;
+}
+
+
+
+
+inline VertexArray_tracking_iterator&
+VertexArray_tracking_iterator::operator-=(difference_type n) noexcept
+{
+    m_index -= n;
+    return *this;
+}
+
+
+
+
+inline VertexArray_iterator VertexArray_tracking_iterator::base() const noexcept
+{
+    return {*m_array, m_index};
+}
@@ -0,0 +1,485 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+    translate()
+    apply_transform()
+    tint()
+    set_tex_offset()
+
+    This file injects the above bulk operations in the `sf` namespace.
+    They process every vertex of an `sf::VertexArray` (or of a contiguous
+    `sf::Vertex` pointer range) in place, working directly on the
+    interleaved `sf::Vertex` layout.
+
+    On x86 with GCC or Clang, SSE2 and AVX2 kernels are compiled with
+    per-function target attributes and the best one is picked once at
+    runtime. Other targets, or builds defining `SF_VA_NO_SIMD`, use the
+    scalar kernels.
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include "VertexArray_iterator.hpp"
+
+#if !defined(SF_VA_NO_SIMD) && (defined(__GNUC__) || defined(__clang__)) \
+    && (defined(__x86_64__) || defined(__i386__))
+#define SF_VA_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+// The kernels address vertex fields by byte offset
+static_assert(sizeof(sf::Vertex) == 20, "unexpected sf::Vertex layout");
+static_assert(offsetof(sf::Vertex, position) == 0, "unexpected sf::Vertex layout");
+static_assert(offsetof(sf::Vertex, color) == 8, "unexpected sf::Vertex layout");
+static_assert(offsetof(sf::Vertex, texCoords) == 12, "unexpected sf::Vertex layout");
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Bulk operations
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace sf
+{
+//* Add `offset` to every vertex position
+void translate(sf::VertexArray&, sf::Vector2f offset) noexcept;
+void translate(sf::Vertex* first, sf::Vertex* last, sf::Vector2f offset) noexcept;
+
+//* Replace every vertex position `p` by `transform.transformPoint(p)`
+void apply_transform(sf::VertexArray&, sf::Transform const&) noexcept;
+void apply_transform(sf::Vertex* first, sf::Vertex* last, sf::Transform const&) noexcept;
+
+//* Modulate every vertex color by `color`, as `sf::Color::operator*` does
+void tint(sf::VertexArray&, sf::Color color) noexcept;
+void tint(sf::Vertex* first, sf::Vertex* last, sf::Color color) noexcept;
+
+//* Add `offset` to every vertex texture coordinates
+void set_tex_offset(sf::VertexArray&, sf::Vector2f offset) noexcept;
+void set_tex_offset(sf::Vertex* first, sf::Vertex* last, sf::Vector2f offset) noexcept;
+
+} // namespace sf
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Impl.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace vertex_array::impl
+{
+enum class Isa { scalar, sse2, avx2 };
+
+
+
+//* Instruction set of the kernels, detected once
+inline Isa runtime_isa() noexcept
+{
+    static Isa const isa = []{
+#ifdef SF_VA_SIMD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return Isa::avx2;
+        if (__builtin_cpu_supports("sse2")) return Isa::sse2;
+#endif
+        return Isa::scalar;
+    }();
+    return isa;
+}
+
+
+
+//* Byte offsets of the fields processed by the kernels
+constexpr std::size_t position_offset   = offsetof(sf::Vertex, position);
+constexpr std::size_t color_offset      = offsetof(sf::Vertex, color);
+constexpr std::size_t tex_coords_offset = offsetof(sf::Vertex, texCoords);
+
+
+
+template <std::size_t Offset>
+inline float* vec2_field(sf::Vertex* vertex) noexcept
+{
+    return reinterpret_cast<float*>(reinterpret_cast<unsigned char*>(vertex) + Offset);
+}
+
+
+
+template <std::size_t Offset>
+inline float const* vec2_field(sf::Vertex const* vertex) noexcept
+{
+    return reinterpret_cast<float const*>(reinterpret_cast<unsigned char const*>(vertex) + Offset);
+}
+
+
+
+inline unsigned char* color_field(sf::Vertex* vertex) noexcept
+{
+    return reinterpret_cast<unsigned char*>(vertex) + color_offset;
+}
+
+
+
+inline unsigned char const* color_field(sf::Vertex const* vertex) noexcept
+{
+    return reinterpret_cast<unsigned char const*>(vertex) + color_offset;
+}
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Scalar kernels
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+template <std::size_t Offset>
+inline void add_vec2_scalar(sf::Vertex* first, std::size_t count, sf::Vector2f offset) noexcept
+{
+    for (std::size_t i=0; i < count; ++i) {
+        float* field = vec2_field<Offset>(first + i);
+        field[0] += offset.x;
+        field[1] += offset.y;
+    }
+}
+
+
+
+inline void transform_scalar(sf::Vertex* first, std::size_t count, sf::Transform const& transform)
+noexcept
+{
+    for (std::size_t i=0; i < count; ++i)
+        first[i].position = transform.transformPoint(first[i].position);
+}
+
+
+
+inline void tint_scalar(sf::Vertex* first, std::size_t count, sf::Color color) noexcept
+{
+    for (std::size_t i=0; i < count; ++i)
+        first[i].color = first[i].color * color;
+}
+
+
+
+
+#ifdef SF_VA_SIMD_X86
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    SSE2 kernels
+
+    Two vertex fields of 8 bytes are packed in one register.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+template <std::size_t Offset>
+__attribute__((target("sse2")))
+inline void add_vec2_sse2(sf::Vertex* first, std::size_t count, sf::Vector2f offset) noexcept
+{
+    __m128 const off = _mm_setr_ps(offset.x, offset.y, offset.x, offset.y);
+    std::size_t i = 0;
+
+    for (; i + 2 <= count; i += 2) {
+        auto* a = reinterpret_cast<__m64*>(vec2_field<Offset>(first + i));
+        auto* b = reinterpret_cast<__m64*>(vec2_field<Offset>(first + i + 1));
+        __m128 v = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), a), b);
+        v = _mm_add_ps(v, off);
+        _mm_storel_pi(a, v);
+        _mm_storeh_pi(b, v);
+    }
+    add_vec2_scalar<Offset>(first + i, count - i, offset);
+}
+
+
+
+__attribute__((target("sse2")))
+inline void transform_sse2(sf::Vertex* first, std::size_t count, sf::Transform const& transform)
+noexcept
+{
+    float const* m = transform.getMatrix();
+    __m128 const col_x = _mm_setr_ps(m[0], m[1], m[0], m[1]);
+    __m128 const col_y = _mm_setr_ps(m[4], m[5], m[4], m[5]);
+    __m128 const col_t = _mm_setr_ps(m[12], m[13], m[12], m[13]);
+    std::size_t i = 0;
+
+    for (; i + 2 <= count; i += 2) {
+        auto* a = reinterpret_cast<__m64*>(vec2_field<position_offset>(first + i));
+        auto* b = reinterpret_cast<__m64*>(vec2_field<position_offset>(first + i + 1));
+        __m128 const v  = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), a), b);
+        __m128 const xx = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 const yy = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 1, 1));
+        __m128 const r  = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xx, col_x), _mm_mul_ps(yy, col_y)), col_t);
+        _mm_storel_pi(a, r);
+        _mm_storeh_pi(b, r);
+    }
+    transform_scalar(first + i, count - i, transform);
+}
+
+
+
+// (x * y) / 255 for 16-bit lanes holding products of two bytes
+__attribute__((target("sse2")))
+inline __m128i div255_epu16_sse2(__m128i x) noexcept
+{
+    x = _mm_add_epi16(x, _mm_add_epi16(_mm_set1_epi16(1), _mm_srli_epi16(x, 8)));
+    return _mm_srli_epi16(x, 8);
+}
+
+
+
+__attribute__((target("sse2")))
+inline void tint_sse2(sf::Vertex* first, std::size_t count, sf::Color color) noexcept
+{
+    __m128i const zero = _mm_setzero_si128();
+    __m128i const mul  = _mm_setr_epi16(
+        color.r, color.g, color.b, color.a, color.r, color.g, color.b, color.a);
+    std::size_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        std::uint32_t packed[4];
+        for (int k=0; k < 4; ++k)
+            std::memcpy(&packed[k], color_field(first + i + k), sizeof(std::uint32_t));
+
+        __m128i const c  = _mm_loadu_si128(reinterpret_cast<__m128i const*>(packed));
+        __m128i const lo = div255_epu16_sse2(_mm_mullo_epi16(_mm_unpacklo_epi8(c, zero), mul));
+        __m128i const hi = div255_epu16_sse2(_mm_mullo_epi16(_mm_unpackhi_epi8(c, zero), mul));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(packed), _mm_packus_epi16(lo, hi));
+
+        for (int k=0; k < 4; ++k)
+            std::memcpy(color_field(first + i + k), &packed[k], sizeof(std::uint32_t));
+    }
+    tint_scalar(first + i, count - i, color);
+}
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    AVX2 kernels
+
+    Four vertex fields of 8 bytes are packed in one register,
+    colors are gathered eight at a time.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+template <std::size_t Offset>
+__attribute__((target("avx2")))
+inline __m256 load_vec2x4_avx2(sf::Vertex const* first) noexcept
+{
+    __m128 const lo = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(),
+        reinterpret_cast<__m64 const*>(vec2_field<Offset>(first))),
+        reinterpret_cast<__m64 const*>(vec2_field<Offset>(first + 1)));
+    __m128 const hi = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(),
+        reinterpret_cast<__m64 const*>(vec2_field<Offset>(first + 2))),
+        reinterpret_cast<__m64 const*>(vec2_field<Offset>(first + 3)));
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+}
+
+
+
+template <std::size_t Offset>
+__attribute__((target("avx2")))
+inline void store_vec2x4_avx2(sf::Vertex* first, __m256 v) noexcept
+{
+    __m128 const lo = _mm256_castps256_ps128(v);
+    __m128 const hi = _mm256_extractf128_ps(v, 1);
+    _mm_storel_pi(reinterpret_cast<__m64*>(vec2_field<Offset>(first)), lo);
+    _mm_storeh_pi(reinterpret_cast<__m64*>(vec2_field<Offset>(first + 1)), lo);
+    _mm_storel_pi(reinterpret_cast<__m64*>(vec2_field<Offset>(first + 2)), hi);
+    _mm_storeh_pi(reinterpret_cast<__m64*>(vec2_field<Offset>(first + 3)), hi);
+}
+
+
+
+template <std::size_t Offset>
+__attribute__((target("avx2")))
+inline void add_vec2_avx2(sf::Vertex* first, std::size_t count, sf::Vector2f offset) noexcept
+{
+    __m256 const off = _mm256_setr_ps(
+        offset.x, offset.y, offset.x, offset.y, offset.x, offset.y, offset.x, offset.y);
+    std::size_t i = 0;
+
+    for (; i + 4 <= count; i += 4)
+        store_vec2x4_avx2<Offset>(first + i, _mm256_add_ps(load_vec2x4_avx2<Offset>(first + i), off));
+
+    add_vec2_scalar<Offset>(first + i, count - i, offset);
+}
+
+
+
+__attribute__((target("avx2")))
+inline void transform_avx2(sf::Vertex* first, std::size_t count, sf::Transform const& transform)
+noexcept
+{
+    float const* m = transform.getMatrix();
+    __m256 const col_x = _mm256_setr_ps(m[0], m[1], m[0], m[1], m[0], m[1], m[0], m[1]);
+    __m256 const col_y = _mm256_setr_ps(m[4], m[5], m[4], m[5], m[4], m[5], m[4], m[5]);
+    __m256 const col_t = _mm256_setr_ps(m[12], m[13], m[12], m[13], m[12], m[13], m[12], m[13]);
+    std::size_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m256 const v  = load_vec2x4_avx2<position_offset>(first + i);
+        __m256 const xx = _mm256_moveldup_ps(v);
+        __m256 const yy = _mm256_movehdup_ps(v);
+        __m256 const r  = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(xx, col_x), _mm256_mul_ps(yy, col_y)), col_t);
+        store_vec2x4_avx2<position_offset>(first + i, r);
+    }
+    transform_scalar(first + i, count - i, transform);
+}
+
+
+
+__attribute__((target("avx2")))
+inline __m256i div255_epu16_avx2(__m256i x) noexcept
+{
+    x = _mm256_add_epi16(x, _mm256_add_epi16(_mm256_set1_epi16(1), _mm256_srli_epi16(x, 8)));
+    return _mm256_srli_epi16(x, 8);
+}
+
+
+
+__attribute__((target("avx2")))
+inline void tint_avx2(sf::Vertex* first, std::size_t count, sf::Color color) noexcept
+{
+    constexpr int stride = sizeof(sf::Vertex) / sizeof(std::int32_t);
+    __m256i const index = _mm256_setr_epi32(
+        0, stride, 2*stride, 3*stride, 4*stride, 5*stride, 6*stride, 7*stride);
+    __m256i const zero  = _mm256_setzero_si256();
+    __m256i const mul   = _mm256_setr_epi16(
+        color.r, color.g, color.b, color.a, color.r, color.g, color.b, color.a,
+        color.r, color.g, color.b, color.a, color.r, color.g, color.b, color.a);
+    std::size_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        auto const* base = reinterpret_cast<int const*>(color_field(first + i));
+        __m256i const c  = _mm256_i32gather_epi32(base, index, 4);
+        __m256i const lo = div255_epu16_avx2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(c, zero), mul));
+        __m256i const hi = div255_epu16_avx2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(c, zero), mul));
+
+        alignas(32) std::uint32_t packed[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(packed), _mm256_packus_epi16(lo, hi));
+        for (int k=0; k < 8; ++k)
+            std::memcpy(color_field(first + i + k), &packed[k], sizeof(std::uint32_t));
+    }
+    tint_scalar(first + i, count - i, color);
+}
+#endif // SF_VA_SIMD_X86
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Dispatch
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+template <std::size_t Offset>
+inline void add_vec2(sf::Vertex* first, std::size_t count, sf::Vector2f offset) noexcept
+{
+#ifdef SF_VA_SIMD_X86
+    switch (runtime_isa()) {
+        case Isa::avx2: return add_vec2_avx2<Offset>(first, count, offset);
+        case Isa::sse2: return add_vec2_sse2<Offset>(first, count, offset);
+        case Isa::scalar: break;
+    }
+#endif
+    add_vec2_scalar<Offset>(first, count, offset);
+}
+
+
+
+inline void transform(sf::Vertex* first, std::size_t count, sf::Transform const& transform)
+noexcept
+{
+#ifdef SF_VA_SIMD_X86
+    switch (runtime_isa()) {
+        case Isa::avx2: return transform_avx2(first, count, transform);
+        case Isa::sse2: return transform_sse2(first, count, transform);
+        case Isa::scalar: break;
+    }
+#endif
+    transform_scalar(first, count, transform);
+}
+
+
+
+inline void tint(sf::Vertex* first, std::size_t count, sf::Color color) noexcept
+{
+#ifdef SF_VA_SIMD_X86
+    switch (runtime_isa()) {
+        case Isa::avx2: return tint_avx2(first, count, color);
+        case Isa::sse2: return tint_sse2(first, count, color);
+        case Isa::scalar: break;
+    }
+#endif
+    tint_scalar(first, count, color);
+}
+
+
+
+} // namespace vertex_array::impl
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Bulk operations implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace sf
+{
+inline void translate(sf::VertexArray& va, sf::Vector2f offset) noexcept
+{
+    translate(sf::contiguous_begin(va), sf::contiguous_end(va), offset);
+}
+
+
+
+
+inline void translate(sf::Vertex* first, sf::Vertex* last, sf::Vector2f offset) noexcept
+{
+    using namespace vertex_array::impl;
+    add_vec2<position_offset>(first, static_cast<std::size_t>(last - first), offset);
+}
+
+
+
+
+inline void apply_transform(sf::VertexArray& va, sf::Transform const& transform) noexcept
+{
+    apply_transform(sf::contiguous_begin(va), sf::contiguous_end(va), transform);
+}
+
+
+
+
+inline void apply_transform(sf::Vertex* first, sf::Vertex* last, sf::Transform const& transform)
+noexcept
+{
+    vertex_array::impl::transform(first, static_cast<std::size_t>(last - first), transform);
+}
+
+
+
+
+inline void tint(sf::VertexArray& va, sf::Color color) noexcept
+{
+    tint(sf::contiguous_begin(va), sf::contiguous_end(va), color);
+}
+
+
+
+
+inline void tint(sf::Vertex* first, sf::Vertex* last, sf::Color color) noexcept
+{
+    vertex_array::impl::tint(first, static_cast<std::size_t>(last - first), color);
+}
+
+
+
+
+inline void set_tex_offset(sf::VertexArray& va, sf::Vector2f offset) noexcept
+{
+    set_tex_offset(sf::contiguous_begin(va), sf::contiguous_end(va), offset);
+}
+
+
+
+
+inline void set_tex_offset(sf::Vertex* first, sf::Vertex* last, sf::Vector2f offset) noexcept
+{
+    using namespace vertex_array::impl;
+    add_vec2<tex_coords_offset>(first, static_cast<std::size_t>(last - first), offset);
+}
+
+
+
+} // namespace sf
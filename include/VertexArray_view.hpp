@@ -0,0 +1,229 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+    class VertexArray_view
+
+    This file defines a non-owning view over the vertices of an
+    `sf::VertexArray`, and injects vertices() in the `sf` namespace.
+
+    In C++20 the view models `std::ranges::view`, `contiguous_range`,
+    `sized_range` and `borrowed_range`, so it composes with the standard
+    range adaptors (`std::views::filter`, `transform`...) without copying
+    vertices.
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#pragma once
+#include <cstddef>
+#include <type_traits>
+#include "VertexArray_iterator.hpp"
+#if __cplusplus > 201703L
+#include <ranges>
+#endif
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class VertexArray_view
+    a pair of forward iterators delimiting a run of vertices.
+
+    @param  Iterator    VertexArray_iterator or VertexArray_const_iterator
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+template <typename Iterator>
+class VertexArray_view
+{
+    static_assert(
+        std::is_same_v<Iterator, VertexArray_iterator>
+        || std::is_same_v<Iterator, VertexArray_const_iterator>,
+        "VertexArray_view is built on the contiguous (forward) iterators"
+    );
+
+public:
+    using iterator          = Iterator;
+    using value_type        = typename Iterator::value_type;
+    using difference_type   = typename Iterator::difference_type;
+    using size_type         = std::size_t;
+    using pointer           = typename Iterator::pointer;
+    using reference         = typename Iterator::reference;
+
+private:
+    Iterator    m_first;
+    Iterator    m_last;
+
+public:
+    VertexArray_view() noexcept = default;
+    VertexArray_view(Iterator first, Iterator last) noexcept;
+
+    Iterator                begin() const noexcept;
+    Iterator                end() const noexcept;
+    pointer                 data() const noexcept;
+    size_type               size() const noexcept;
+    bool                    empty() const noexcept;
+    reference               operator[](size_type) const noexcept;
+    reference               front() const noexcept;
+    reference               back() const noexcept;
+
+    VertexArray_view        subview(size_type offset, size_type count) const noexcept;
+
+    // allow passing a mutable view where a const one is expected
+    template <typename It = Iterator,
+        typename = std::enable_if_t<std::is_same_v<It, VertexArray_iterator>>>
+    operator VertexArray_view<VertexArray_const_iterator>() const noexcept
+    {
+        return {m_first, m_last};
+    }
+
+};
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    opt in the standard ranges library
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#if __cplusplus > 201703L
+template <typename Iterator>
+inline constexpr bool std::ranges::enable_view<VertexArray_view<Iterator>> = true;
+
+template <typename Iterator>
+inline constexpr bool std::ranges::enable_borrowed_range<VertexArray_view<Iterator>> = true;
+
+static_assert(std::ranges::view<VertexArray_view<VertexArray_iterator>>);
+static_assert(std::ranges::contiguous_range<VertexArray_view<VertexArray_iterator>>);
+static_assert(std::ranges::sized_range<VertexArray_view<VertexArray_iterator>>);
+static_assert(std::ranges::borrowed_range<VertexArray_view<VertexArray_iterator>>);
+static_assert(std::ranges::view<VertexArray_view<VertexArray_const_iterator>>);
+static_assert(std::ranges::contiguous_range<VertexArray_view<VertexArray_const_iterator>>);
+static_assert(std::ranges::sized_range<VertexArray_view<VertexArray_const_iterator>>);
+static_assert(std::ranges::borrowed_range<VertexArray_view<VertexArray_const_iterator>>);
+#endif
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    vertices()
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace sf
+{
+VertexArray_view<VertexArray_iterator>          vertices(sf::VertexArray&) noexcept;
+VertexArray_view<VertexArray_const_iterator>    vertices(sf::VertexArray const&) noexcept;
+void                                            vertices(sf::VertexArray&&) = delete;
+
+
+
+
+inline VertexArray_view<VertexArray_iterator> vertices(sf::VertexArray& va) noexcept
+{
+    return {sf::begin(va), sf::end(va)};
+}
+
+
+
+
+inline VertexArray_view<VertexArray_const_iterator> vertices(sf::VertexArray const& va)
+noexcept
+{
+    return {sf::cbegin(va), sf::cend(va)};
+}
+
+
+
+} // namespace sf
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    view implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+template <typename It>
+VertexArray_view<It>::VertexArray_view(It first, It last) noexcept
+    : m_first   {first}
+    , m_last    {last}
+{
+}
+
+
+
+
+template <typename It>
+It VertexArray_view<It>::begin() const noexcept
+{
+    return m_first;
+}
+
+
+
+
+template <typename It>
+It VertexArray_view<It>::end() const noexcept
+{
+    return m_last;
+}
+
+
+
+
+template <typename It>
+auto VertexArray_view<It>::data() const noexcept
+    -> typename VertexArray_view<It>::pointer
+{
+    return m_first.operator->();
+}
+
+
+
+
+template <typename It>
+auto VertexArray_view<It>::size() const noexcept
+    -> typename VertexArray_view<It>::size_type
+{
+    return static_cast<size_type>(m_last - m_first);
+}
+
+
+
+
+template <typename It>
+bool VertexArray_view<It>::empty() const noexcept
+{
+    return m_first == m_last;
+}
+
+
+
+
+template <typename It>
+auto VertexArray_view<It>::operator[](size_type idx) const noexcept
+    -> typename VertexArray_view<It>::reference
+{
+    return m_first[static_cast<difference_type>(idx)];
+}
+
+
+
+
+template <typename It>
+auto VertexArray_view<It>::front() const noexcept
+    -> typename VertexArray_view<It>::reference
+{
+    return *m_first;
+}
+
+
+
+
+template <typename It>
+auto VertexArray_view<It>::back() const noexcept
+    -> typename VertexArray_view<It>::reference
+{
+    return *(m_last - 1);
+}
+
+
+
+
+template <typename It>
+auto VertexArray_view<It>::subview(size_type offset, size_type count) const noexcept
+    -> VertexArray_view<It>
+{
+    auto const first = m_first + static_cast<difference_type>(offset);
+    return {first, first + static_cast<difference_type>(count)};
+}
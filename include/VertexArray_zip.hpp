@@ -0,0 +1,740 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+    class VertexArray_zip_iterator
+    class VertexArray_zip_view
+    zip()
+    lerp_positions()
+    lerp_colors()
+
+    This file defines an iterator walking several `sf::VertexArray`s in
+    lock-step, and injects zip() in the `sf` namespace. Dereferencing
+    yields a tuple of references to the i-th vertex of every array, so
+    that keyframes can be blended without indexing each array:
+
+        for (auto [a, b, out] : sf::zip(key_a, key_b, morphed))
+            out.position = a.position + (b.position - a.position) * t;
+
+    Arrays passed as const are walked with `VertexArray_const_iterator`,
+    the others with `VertexArray_iterator`. The zipped range stops at the
+    end of the shortest array.
+
+    It also injects lerp_positions() and lerp_colors(), which blend two
+    zipped arrays into a third one with SSE2 / AVX2 kernels:
+
+        sf::lerp_positions(sf::zip(key_a, key_b, morphed), t);
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include "VertexArray_iterator.hpp"
+#include "VertexArray_transform.hpp"
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class VertexArray_zip_iterator
+    moves the iterators of several arrays together.
+
+    Dereferencing yields a tuple of references (a proxy), so the iterator
+    is a legacy input iterator with random-access operations.
+
+    @param  Iterators   VertexArray_iterator or VertexArray_const_iterator
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+template <typename... Iterators>
+class VertexArray_zip_iterator
+{
+    static_assert(sizeof...(Iterators) > 0, "zip at least one array");
+    static_assert(
+        ((std::is_same_v<Iterators, VertexArray_iterator>
+            || std::is_same_v<Iterators, VertexArray_const_iterator>) && ...),
+        "VertexArray_zip_iterator is built on the contiguous (forward) iterators"
+    );
+
+public:
+    using value_type        = std::tuple<typename Iterators::value_type...>;
+    using reference         = std::tuple<typename Iterators::reference...>;
+    using pointer           = void;
+    using difference_type   = std::ptrdiff_t;
+    using iterator_category = std::input_iterator_tag;
+#if __cplusplus > 201703L
+    using iterator_concept  = std::random_access_iterator_tag;
+#endif
+
+private:
+    std::tuple<Iterators...>    m_iterators;
+
+public:
+    VertexArray_zip_iterator() noexcept = default;
+    explicit VertexArray_zip_iterator(Iterators... iterators) noexcept;
+
+    // The underlying iterators
+    std::tuple<Iterators...> const& base() const noexcept;
+
+    reference                   operator*() const noexcept;
+    reference                   operator[](difference_type) const noexcept;
+
+    VertexArray_zip_iterator&   operator++() noexcept;
+    VertexArray_zip_iterator    operator++(int) noexcept;
+    VertexArray_zip_iterator&   operator--() noexcept;
+    VertexArray_zip_iterator    operator--(int) noexcept;
+    VertexArray_zip_iterator&   operator+=(difference_type) noexcept;
+    VertexArray_zip_iterator&   operator-=(difference_type) noexcept;
+
+    friend VertexArray_zip_iterator operator+(VertexArray_zip_iterator it, difference_type n) noexcept
+    {
+        return it += n;
+    }
+
+    friend VertexArray_zip_iterator operator+(difference_type n, VertexArray_zip_iterator it) noexcept
+    {
+        return it += n;
+    }
+
+    friend VertexArray_zip_iterator operator-(VertexArray_zip_iterator it, difference_type n) noexcept
+    {
+        return it -= n;
+    }
+
+    // The iterators move together: the first one stands for all of them
+    friend difference_type operator-(
+        VertexArray_zip_iterator const& lhs,
+        VertexArray_zip_iterator const& rhs
+    ) noexcept
+    {
+        return std::get<0>(lhs.m_iterators) - std::get<0>(rhs.m_iterators);
+    }
+
+    friend bool operator==(VertexArray_zip_iterator const& lhs, VertexArray_zip_iterator const& rhs) noexcept
+    {
+        return std::get<0>(lhs.m_iterators) == std::get<0>(rhs.m_iterators);
+    }
+
+    friend bool operator!=(VertexArray_zip_iterator const& lhs, VertexArray_zip_iterator const& rhs) noexcept
+    {
+        return std::get<0>(lhs.m_iterators) != std::get<0>(rhs.m_iterators);
+    }
+
+    friend bool operator<(VertexArray_zip_iterator const& lhs, VertexArray_zip_iterator const& rhs) noexcept
+    {
+        return std::get<0>(lhs.m_iterators) < std::get<0>(rhs.m_iterators);
+    }
+
+    friend bool operator>(VertexArray_zip_iterator const& lhs, VertexArray_zip_iterator const& rhs) noexcept
+    {
+        return rhs < lhs;
+    }
+
+    friend bool operator<=(VertexArray_zip_iterator const& lhs, VertexArray_zip_iterator const& rhs) noexcept
+    {
+        return !(rhs < lhs);
+    }
+
+    friend bool operator>=(VertexArray_zip_iterator const& lhs, VertexArray_zip_iterator const& rhs) noexcept
+    {
+        return !(lhs < rhs);
+    }
+
+};
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class VertexArray_zip_view
+    the first `size()` vertices of several arrays, walked in lock-step.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+template <typename... Iterators>
+class VertexArray_zip_view
+{
+public:
+    using iterator          = VertexArray_zip_iterator<Iterators...>;
+    using value_type        = typename iterator::value_type;
+    using reference         = typename iterator::reference;
+    using difference_type   = typename iterator::difference_type;
+    using size_type         = std::size_t;
+
+private:
+    iterator        m_first;
+    size_type       m_size = 0;
+
+public:
+    VertexArray_zip_view() noexcept = default;
+    VertexArray_zip_view(iterator first, size_type size) noexcept;
+
+    iterator                begin() const noexcept;
+    iterator                end() const noexcept;
+    size_type               size() const noexcept;
+    bool                    empty() const noexcept;
+    reference               operator[](size_type) const noexcept;
+
+    // First vertex of the `I`-th array, null when the view is empty
+    template <std::size_t I>
+    auto                    data() const noexcept;
+
+};
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    zip(), lerp_positions(), lerp_colors()
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace vertex_array::impl
+{
+template <typename Array>
+using zip_iterator_t = std::conditional_t<std::is_const_v<Array>,
+    VertexArray_const_iterator,
+    VertexArray_iterator
+>;
+
+} // namespace vertex_array::impl
+
+
+
+namespace sf
+{
+template <typename... Arrays>
+VertexArray_zip_view<vertex_array::impl::zip_iterator_t<Arrays>...>
+zip(Arrays&... arrays) noexcept;
+
+/**
+ *  out.position = a.position + (b.position - a.position) * t
+ *  for every vertex of a view returned by `zip(a, b, out)`.
+ *  `out` may be `a` or `b`.
+ */
+template <typename A_it, typename B_it>
+void lerp_positions(VertexArray_zip_view<A_it, B_it, VertexArray_iterator>, float t) noexcept;
+
+void lerp_positions(sf::Vertex const* a, sf::Vertex const* b, sf::Vertex* out,
+    std::size_t count, float t) noexcept;
+
+/**
+ *  Blend the colors of a view returned by `zip(a, b, out)`, with `t`
+ *  clamped to [0, 1] and quantized to 1/256 steps. `out` may be `a` or `b`.
+ */
+template <typename A_it, typename B_it>
+void lerp_colors(VertexArray_zip_view<A_it, B_it, VertexArray_iterator>, float t) noexcept;
+
+void lerp_colors(sf::Vertex const* a, sf::Vertex const* b, sf::Vertex* out,
+    std::size_t count, float t) noexcept;
+
+} // namespace sf
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Impl.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace vertex_array::impl
+{
+//* Weight of `b` in 1/256 steps
+inline std::uint16_t color_weight(float t) noexcept
+{
+    t = std::clamp(t, 0.f, 1.f);
+    return static_cast<std::uint16_t>(std::lround(t * 256.f));
+}
+
+
+
+inline std::uint8_t lerp_channel(std::uint8_t a, std::uint8_t b, unsigned weight) noexcept
+{
+    return static_cast<std::uint8_t>((a * (256 - weight) + b * weight + 128) >> 8);
+}
+
+
+
+inline void lerp_positions_scalar(
+    sf::Vertex const*   a,
+    sf::Vertex const*   b,
+    sf::Vertex*         out,
+    std::size_t         count,
+    float               t
+) noexcept
+{
+    for (std::size_t i=0; i < count; ++i) {
+        float const* pa = vec2_field<position_offset>(a + i);
+        float const* pb = vec2_field<position_offset>(b + i);
+        float* po = vec2_field<position_offset>(out + i);
+        float const x = pa[0] + (pb[0] - pa[0]) * t;
+        float const y = pa[1] + (pb[1] - pa[1]) * t;
+        po[0] = x;
+        po[1] = y;
+    }
+}
+
+
+
+inline void lerp_colors_scalar(
+    sf::Vertex const*   a,
+    sf::Vertex const*   b,
+    sf::Vertex*         out,
+    std::size_t         count,
+    unsigned            weight
+) noexcept
+{
+    for (std::size_t i=0; i < count; ++i) {
+        unsigned char const* ca = color_field(a + i);
+        unsigned char const* cb = color_field(b + i);
+        unsigned char blended[4];
+        for (int k=0; k < 4; ++k)
+            blended[k] = lerp_channel(ca[k], cb[k], weight);
+        std::memcpy(color_field(out + i), blended, sizeof blended);
+    }
+}
+
+
+
+#ifdef SF_VA_SIMD_X86
+__attribute__((target("sse2")))
+inline __m128 load_positions_x2_sse2(sf::Vertex const* first) noexcept
+{
+    return _mm_loadh_pi(
+        _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<__m64 const*>(vec2_field<position_offset>(first))),
+        reinterpret_cast<__m64 const*>(vec2_field<position_offset>(first + 1))
+    );
+}
+
+
+
+__attribute__((target("sse2")))
+inline void lerp_positions_sse2(
+    sf::Vertex const*   a,
+    sf::Vertex const*   b,
+    sf::Vertex*         out,
+    std::size_t         count,
+    float               t
+) noexcept
+{
+    __m128 const tt = _mm_set1_ps(t);
+    std::size_t i = 0;
+
+    for (; i + 2 <= count; i += 2) {
+        __m128 const va = load_positions_x2_sse2(a + i);
+        __m128 const vb = load_positions_x2_sse2(b + i);
+        __m128 const r  = _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(vb, va), tt));
+        _mm_storel_pi(reinterpret_cast<__m64*>(vec2_field<position_offset>(out + i)), r);
+        _mm_storeh_pi(reinterpret_cast<__m64*>(vec2_field<position_offset>(out + i + 1)), r);
+    }
+    lerp_positions_scalar(a + i, b + i, out + i, count - i, t);
+}
+
+
+
+// Blend two registers of 16-bit channels: (a * (256 - w) + b * w + 128) >> 8
+__attribute__((target("sse2")))
+inline __m128i lerp_epu16_sse2(__m128i a, __m128i b, __m128i wa, __m128i wb) noexcept
+{
+    __m128i const sum = _mm_add_epi16(_mm_mullo_epi16(a, wa), _mm_mullo_epi16(b, wb));
+    return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(128)), 8);
+}
+
+
+
+__attribute__((target("sse2")))
+inline void lerp_colors_sse2(
+    sf::Vertex const*   a,
+    sf::Vertex const*   b,
+    sf::Vertex*         out,
+    std::size_t         count,
+    unsigned            weight
+) noexcept
+{
+    __m128i const zero = _mm_setzero_si128();
+    __m128i const wa   = _mm_set1_epi16(static_cast<short>(256 - weight));
+    __m128i const wb   = _mm_set1_epi16(static_cast<short>(weight));
+    std::size_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        std::uint32_t pa[4], pb[4];
+        for (int k=0; k < 4; ++k) {
+            std::memcpy(&pa[k], color_field(a + i + k), sizeof(std::uint32_t));
+            std::memcpy(&pb[k], color_field(b + i + k), sizeof(std::uint32_t));
+        }
+
+        __m128i const ca = _mm_loadu_si128(reinterpret_cast<__m128i const*>(pa));
+        __m128i const cb = _mm_loadu_si128(reinterpret_cast<__m128i const*>(pb));
+        __m128i const lo = lerp_epu16_sse2(_mm_unpacklo_epi8(ca, zero), _mm_unpacklo_epi8(cb, zero), wa, wb);
+        __m128i const hi = lerp_epu16_sse2(_mm_unpackhi_epi8(ca, zero), _mm_unpackhi_epi8(cb, zero), wa, wb);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pa), _mm_packus_epi16(lo, hi));
+
+        for (int k=0; k < 4; ++k)
+            std::memcpy(color_field(out + i + k), &pa[k], sizeof(std::uint32_t));
+    }
+    lerp_colors_scalar(a + i, b + i, out + i, count - i, weight);
+}
+
+
+
+__attribute__((target("avx2")))
+inline void lerp_positions_avx2(
+    sf::Vertex const*   a,
+    sf::Vertex const*   b,
+    sf::Vertex*         out,
+    std::size_t         count,
+    float               t
+) noexcept
+{
+    __m256 const tt = _mm256_set1_ps(t);
+    std::size_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m256 const va = load_vec2x4_avx2<position_offset>(a + i);
+        __m256 const vb = load_vec2x4_avx2<position_offset>(b + i);
+        store_vec2x4_avx2<position_offset>(out + i, _mm256_add_ps(va, _mm256_mul_ps(_mm256_sub_ps(vb, va), tt)));
+    }
+    lerp_positions_scalar(a + i, b + i, out + i, count - i, t);
+}
+
+
+
+__attribute__((target("avx2")))
+inline __m256i lerp_epu16_avx2(__m256i a, __m256i b, __m256i wa, __m256i wb) noexcept
+{
+    __m256i const sum = _mm256_add_epi16(_mm256_mullo_epi16(a, wa), _mm256_mullo_epi16(b, wb));
+    return _mm256_srli_epi16(_mm256_add_epi16(sum, _mm256_set1_epi16(128)), 8);
+}
+
+
+
+__attribute__((target("avx2")))
+inline void lerp_colors_avx2(
+    sf::Vertex const*   a,
+    sf::Vertex const*   b,
+    sf::Vertex*         out,
+    std::size_t         count,
+    unsigned            weight
+) noexcept
+{
+    constexpr int stride = sizeof(sf::Vertex) / sizeof(std::int32_t);
+    __m256i const index = _mm256_setr_epi32(
+        0, stride, 2*stride, 3*stride, 4*stride, 5*stride, 6*stride, 7*stride);
+    __m256i const zero  = _mm256_setzero_si256();
+    __m256i const wa    = _mm256_set1_epi16(static_cast<short>(256 - weight));
+    __m256i const wb    = _mm256_set1_epi16(static_cast<short>(weight));
+    std::size_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i const ca = _mm256_i32gather_epi32(reinterpret_cast<int const*>(color_field(a + i)), index, 4);
+        __m256i const cb = _mm256_i32gather_epi32(reinterpret_cast<int const*>(color_field(b + i)), index, 4);
+        __m256i const lo = lerp_epu16_avx2(_mm256_unpacklo_epi8(ca, zero), _mm256_unpacklo_epi8(cb, zero), wa, wb);
+        __m256i const hi = lerp_epu16_avx2(_mm256_unpackhi_epi8(ca, zero), _mm256_unpackhi_epi8(cb, zero), wa, wb);
+
+        alignas(32) std::uint32_t packed[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(packed), _mm256_packus_epi16(lo, hi));
+        for (int k=0; k < 8; ++k)
+            std::memcpy(color_field(out + i + k), &packed[k], sizeof(std::uint32_t));
+    }
+    lerp_colors_scalar(a + i, b + i, out + i, count - i, weight);
+}
+#endif // SF_VA_SIMD_X86
+
+
+
+inline void lerp_positions(
+    sf::Vertex const*   a,
+    sf::Vertex const*   b,
+    sf::Vertex*         out,
+    std::size_t         count,
+    float               t
+) noexcept
+{
+#ifdef SF_VA_SIMD_X86
+    switch (runtime_isa()) {
+        case Isa::avx2: return lerp_positions_avx2(a, b, out, count, t);
+        case Isa::sse2: return lerp_positions_sse2(a, b, out, count, t);
+        case Isa::scalar: break;
+    }
+#endif
+    lerp_positions_scalar(a, b, out, count, t);
+}
+
+
+
+inline void lerp_colors(
+    sf::Vertex const*   a,
+    sf::Vertex const*   b,
+    sf::Vertex*         out,
+    std::size_t         count,
+    unsigned            weight
+) noexcept
+{
+#ifdef SF_VA_SIMD_X86
+    switch (runtime_isa()) {
+        case Isa::avx2: return lerp_colors_avx2(a, b, out, count, weight);
+        case Isa::sse2: return lerp_colors_sse2(a, b, out, count, weight);
+        case Isa::scalar: break;
+    }
+#endif
+    lerp_colors_scalar(a, b, out, count, weight);
+}
+
+
+
+} // namespace vertex_array::impl
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    zip(), lerp_positions(), lerp_colors() implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace sf
+{
+template <typename... Arrays>
+VertexArray_zip_view<vertex_array::impl::zip_iterator_t<Arrays>...>
+zip(Arrays&... arrays) noexcept
+{
+    static_assert((std::is_same_v<std::remove_const_t<Arrays>, sf::VertexArray> && ...),
+        "zip() walks sf::VertexArrays");
+
+    auto const size = std::min({arrays.getVertexCount()...});
+    return {
+        VertexArray_zip_iterator<vertex_array::impl::zip_iterator_t<Arrays>...>{
+            vertex_array::impl::zip_iterator_t<Arrays>{arrays, 0}...
+        },
+        size
+    };
+}
+
+
+
+
+template <typename A_it, typename B_it>
+void lerp_positions(VertexArray_zip_view<A_it, B_it, VertexArray_iterator> zipped, float t) noexcept
+{
+    lerp_positions(zipped.template data<0>(), zipped.template data<1>(), zipped.template data<2>(),
+        zipped.size(), t);
+}
+
+
+
+
+inline void lerp_positions(
+    sf::Vertex const*   a,
+    sf::Vertex const*   b,
+    sf::Vertex*         out,
+    std::size_t         count,
+    float               t
+) noexcept
+{
+    vertex_array::impl::lerp_positions(a, b, out, count, t);
+}
+
+
+
+
+template <typename A_it, typename B_it>
+void lerp_colors(VertexArray_zip_view<A_it, B_it, VertexArray_iterator> zipped, float t) noexcept
+{
+    lerp_colors(zipped.template data<0>(), zipped.template data<1>(), zipped.template data<2>(),
+        zipped.size(), t);
+}
+
+
+
+
+inline void lerp_colors(
+    sf::Vertex const*   a,
+    sf::Vertex const*   b,
+    sf::Vertex*         out,
+    std::size_t         count,
+    float               t
+) noexcept
+{
+    vertex_array::impl::lerp_colors(a, b, out, count, vertex_array::impl::color_weight(t));
+}
+
+
+
+} // namespace sf
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    zip iterator implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+template <typename... Its>
+VertexArray_zip_iterator<Its...>::VertexArray_zip_iterator(Its... iterators) noexcept
+    : m_iterators {iterators...}
+{
+}
+
+
+
+
+template <typename... Its>
+auto VertexArray_zip_iterator<Its...>::base() const noexcept
+    -> std::tuple<Its...> const&
+{
+    return m_iterators;
+}
+
+
+
+
+template <typename... Its>
+auto VertexArray_zip_iterator<Its...>::operator*() const noexcept
+    -> typename VertexArray_zip_iterator<Its...>::reference
+{
+    return std::apply([](auto const&... it) { return reference{*it...}; }, m_iterators);
+}
+
+
+
+
+template <typename... Its>
+auto VertexArray_zip_iterator<Its...>::operator[](difference_type n) const noexcept
+    -> typename VertexArray_zip_iterator<Its...>::reference
+{
+    return *(*this + n);
+}
+
+
+
+
+template <typename... Its>
+auto VertexArray_zip_iterator<Its...>::operator++() noexcept
+    -> VertexArray_zip_iterator&
+{
+    std::apply([](auto&... it) { (++it, ...); }, m_iterators);
+    return *this;
+}
+
+
+
+
+template <typename... Its>
+auto VertexArray_zip_iterator<Its...>::operator++(int) noexcept
+    -> VertexArray_zip_iterator
+{
+    auto copy = *this;
+    ++*this;
+    return copy;
+}
+
+
+
+
+template <typename... Its>
+auto VertexArray_zip_iterator<Its...>::operator--() noexcept
+    -> VertexArray_zip_iterator&
+{
+    std::apply([](auto&... it) { (--it, ...); }, m_iterators);
+    return *this;
+}
+
+
+
+
+template <typename... Its>
+auto VertexArray_zip_iterator<Its...>::operator--(int) noexcept
+    -> VertexArray_zip_iterator
+{
+    auto copy = *this;
+    --*this;
+    return copy;
+}
+
+
+
+
+template <typename... Its>
+auto VertexArray_zip_iterator<Its...>::operator+=(difference_type n) noexcept
+    -> VertexArray_zip_iterator&
+{
+    std::apply([n](auto&... it) { ((it += n), ...); }, m_iterators);
+    return *this;
+}
+
+
+
+
+template <typename... Its>
+auto VertexArray_zip_iterator<Its...>::operator-=(difference_type n) noexcept
+    -> VertexArray_zip_iterator&
+{
+    std::apply([n](auto&... it) { ((it -= n), ...); }, m_iterators);
+    return *this;
+}
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    zip view implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+template <typename... Its>
+VertexArray_zip_view<Its...>::VertexArray_zip_view(iterator first, size_type size) noexcept
+    : m_first   {first}
+    , m_size    {size}
+{
+}
+
+
+
+
+template <typename... Its>
+auto VertexArray_zip_view<Its...>::begin() const noexcept
+    -> typename VertexArray_zip_view<Its...>::iterator
+{
+    return m_first;
+}
+
+
+
+
+template <typename... Its>
+auto VertexArray_zip_view<Its...>::end() const noexcept
+    -> typename VertexArray_zip_view<Its...>::iterator
+{
+    return m_first + static_cast<difference_type>(m_size);
+}
+
+
+
+
+template <typename... Its>
+auto VertexArray_zip_view<Its...>::size() const noexcept
+    -> typename VertexArray_zip_view<Its...>::size_type
+{
+    return m_size;
+}
+
+
+
+
+template <typename... Its>
+bool VertexArray_zip_view<Its...>::empty() const noexcept
+{
+    return m_size == 0;
+}
+
+
+
+
+template <typename... Its>
+auto VertexArray_zip_view<Its...>::operator[](size_type idx) const noexcept
+    -> typename VertexArray_zip_view<Its...>::reference
+{
+    return m_first[static_cast<difference_type>(idx)];
+}
+
+
+
+
+template <typename... Its>
+template <std::size_t I>
+auto VertexArray_zip_view<Its...>::data() const noexcept
+{
+    return m_size != 0 ? std::get<I>(m_first.base()).operator->() : nullptr;
+}
@@ -0,0 +1,421 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+    class VertexCuller
+
+    This file defines a uniform-grid spatial index over the primitives of
+    one or more `sf::VertexArray`s. Given a view rectangle, cull() writes
+    the vertices of the visible primitives only, in array then primitive
+    order, to any output iterator (e.g. `sf::back_inserter(va)`).
+
+    The index is built once per array and updated incrementally for the
+    primitives that moved. Primitive bounds of large arrays are computed
+    on several threads.
+
+    List primitive types (Points, Lines, Triangles, Quads) are culled one
+    primitive at a time. Strips and fans share vertices between their
+    primitives, so such an array is culled as a whole.
+
+    Primitives with a NaN coordinate are never culled in. Primitives
+    covering more than `max_cells_per_primitive` cells are kept out of the
+    grid and tested against every view.
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include "VertexArray_iterator.hpp"
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class VertexCuller
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+class VertexCuller
+{
+public:
+    using source_id = std::size_t;
+
+    // Arrays with more primitives have their bounds computed on several threads
+    static constexpr std::size_t parallel_threshold = 1 << 16;
+
+    // Larger primitives are tested against every view rather than gridded
+    static constexpr std::uint64_t max_cells_per_primitive = 1024;
+
+    // Cell coordinates are clamped to [-max_cell, max_cell], far from the int32 limits
+    static constexpr std::int32_t max_cell = 1 << 24;
+
+private:
+    struct Cell_range
+    {
+        std::int32_t left = 0, top = 0, right = -1, bottom = -1;    // inclusive
+    };
+
+    struct Primitive
+    {
+        sf::FloatRect   bounds;
+        Cell_range      cells;
+    };
+
+    struct Source
+    {
+        sf::VertexArray const*  array = nullptr;
+        std::size_t             vertices_per_primitive = 0;
+        std::vector<Primitive>  primitives;
+    };
+
+    struct Entry
+    {
+        std::uint32_t   source;
+        std::uint32_t   primitive;
+    };
+
+    float                                               m_cell_size;
+    std::vector<Source>                                 m_sources;
+    std::unordered_map<std::uint64_t, std::vector<Entry>> m_grid;
+    std::vector<Entry>                                  m_large;        // too large for the grid
+    std::vector<Entry>                                  m_candidates;
+
+public:
+    explicit VertexCuller(float cell_size = 256.f);
+
+    // Index `va`, which must outlive the culler or be removed first
+    source_id           add(sf::VertexArray const& va);
+    void                remove(source_id);
+
+    // Re-index the primitives [first, last) of a source after they moved, clamped to the source
+    void                update(source_id, std::size_t first, std::size_t last);
+    // Re-index a whole source, after it was resized
+    void                rebuild(source_id);
+
+    std::size_t         primitive_count(source_id) const noexcept;
+
+    template <typename Output_it>
+    Output_it           cull(sf::FloatRect const& view, Output_it out);
+
+private:
+    static std::size_t  vertices_per_primitive(sf::PrimitiveType) noexcept;
+    static std::uint64_t cell_key(std::int32_t x, std::int32_t y) noexcept;
+    static bool         overlaps(sf::FloatRect const&, sf::FloatRect const&) noexcept;
+    static std::uint64_t cell_count(Cell_range const&) noexcept;
+
+    Cell_range          cells_of(sf::FloatRect const&) const noexcept;
+    void                insert(std::uint32_t source, std::uint32_t primitive);
+    void                erase(std::uint32_t source, std::uint32_t primitive);
+    void                compute_bounds(Source&, std::size_t first, std::size_t last) const;
+
+};
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    VertexCuller implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+inline VertexCuller::VertexCuller(float cell_size)
+    : m_cell_size   {cell_size}
+{
+}
+
+
+
+
+inline auto VertexCuller::add(sf::VertexArray const& va) -> source_id
+{
+    // reuse the slot of a removed source
+    auto slot = std::find_if(m_sources.begin(), m_sources.end(), [](Source const& source) {
+        return source.array == nullptr;
+    });
+    if (slot == m_sources.end()) {
+        slot = m_sources.insert(m_sources.end(), Source{});
+    }
+
+    slot->array = &va;
+    auto const id = static_cast<source_id>(slot - m_sources.begin());
+    rebuild(id);
+    return id;
+}
+
+
+
+
+inline void VertexCuller::remove(source_id id)
+{
+    auto& source = m_sources[id];
+
+    for (std::size_t i=0; i < source.primitives.size(); ++i)
+        erase(static_cast<std::uint32_t>(id), static_cast<std::uint32_t>(i));
+
+    source = Source{};
+}
+
+
+
+
+inline void VertexCuller::update(source_id id, std::size_t first, std::size_t last)
+{
+    auto& source = m_sources[id];
+    last = std::min(last, source.primitives.size());
+    first = std::min(first, last);
+
+    for (auto i = first; i < last; ++i)
+        erase(static_cast<std::uint32_t>(id), static_cast<std::uint32_t>(i));
+
+    compute_bounds(source, first, last);
+
+    for (auto i = first; i < last; ++i)
+        insert(static_cast<std::uint32_t>(id), static_cast<std::uint32_t>(i));
+}
+
+
+
+
+inline void VertexCuller::rebuild(source_id id)
+{
+    auto& source = m_sources[id];
+
+    for (std::size_t i=0; i < source.primitives.size(); ++i)
+        erase(static_cast<std::uint32_t>(id), static_cast<std::uint32_t>(i));
+
+    auto const vertex_count = source.array->getVertexCount();
+    auto const per_primitive = vertices_per_primitive(source.array->getPrimitiveType());
+    source.vertices_per_primitive = per_primitive != 0 ? per_primitive : std::max<std::size_t>(vertex_count, 1);
+    source.primitives.assign(vertex_count / source.vertices_per_primitive, Primitive{});
+
+    compute_bounds(source, 0, source.primitives.size());
+
+    for (std::size_t i=0; i < source.primitives.size(); ++i)
+        insert(static_cast<std::uint32_t>(id), static_cast<std::uint32_t>(i));
+}
+
+
+
+
+inline std::size_t VertexCuller::primitive_count(source_id id) const noexcept
+{
+    return m_sources[id].primitives.size();
+}
+
+
+
+
+template <typename Output_it>
+Output_it VertexCuller::cull(sf::FloatRect const& view, Output_it out)
+{
+    auto const range = cells_of(view);
+    m_candidates.clear();
+
+    auto const visit = [&](std::vector<Entry> const& entries) {
+        for (auto const& entry : entries) {
+            auto const& primitive = m_sources[entry.source].primitives[entry.primitive];
+            if (overlaps(primitive.bounds, view))
+                m_candidates.push_back(entry);
+        }
+    };
+    visit(m_large);
+
+    if (cell_count(range) > m_grid.size()) {
+        // a view wider than the indexed area: walk the cells that exist instead
+        for (auto const& [key, entries] : m_grid) {
+            auto const x = static_cast<std::int32_t>(static_cast<std::uint32_t>(key >> 32));
+            auto const y = static_cast<std::int32_t>(static_cast<std::uint32_t>(key));
+            if (range.left <= x && x <= range.right && range.top <= y && y <= range.bottom)
+                visit(entries);
+        }
+    }
+    else {
+        for (auto y = range.top; y <= range.bottom; ++y)
+        for (auto x = range.left; x <= range.right; ++x)
+        {
+            auto const cell = m_grid.find(cell_key(x, y));
+            if (cell != m_grid.end())
+                visit(cell->second);
+        }
+    }
+
+    // primitives spanning several cells show up once per cell
+    std::sort(m_candidates.begin(), m_candidates.end(), [](Entry const& a, Entry const& b) {
+        return a.source != b.source ? a.source < b.source : a.primitive < b.primitive;
+    });
+    auto const last = std::unique(m_candidates.begin(), m_candidates.end(), [](Entry const& a, Entry const& b) {
+        return a.source == b.source && a.primitive == b.primitive;
+    });
+
+    for (auto it = m_candidates.begin(); it != last; ++it)
+    {
+        auto const& source = m_sources[it->source];
+        auto const first = sf::contiguous_begin(*source.array) + it->primitive * source.vertices_per_primitive;
+        out = std::copy(first, first + source.vertices_per_primitive, out);
+    }
+    return out;
+}
+
+
+
+
+inline std::size_t VertexCuller::vertices_per_primitive(sf::PrimitiveType type) noexcept
+{
+    switch (type) {
+        case sf::Points:    return 1;
+        case sf::Lines:     return 2;
+        case sf::Triangles: return 3;
+        case sf::Quads:     return 4;
+        default:            return 0;   // the whole array is one primitive
+    }
+}
+
+
+
+
+inline std::uint64_t VertexCuller::cell_key(std::int32_t x, std::int32_t y) noexcept
+{
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32)
+         | static_cast<std::uint32_t>(y);
+}
+
+
+
+
+// Closed-interval test, so that points and axis-aligned lines are not lost
+inline bool VertexCuller::overlaps(sf::FloatRect const& a, sf::FloatRect const& b) noexcept
+{
+    return a.left <= b.left + b.width && b.left <= a.left + a.width
+        && a.top <= b.top + b.height  && b.top <= a.top + a.height;
+}
+
+
+
+
+inline std::uint64_t VertexCuller::cell_count(Cell_range const& cells) noexcept
+{
+    if (cells.right < cells.left || cells.bottom < cells.top) {
+        return 0;
+    }
+    return static_cast<std::uint64_t>(std::int64_t{cells.right} - cells.left + 1)
+         * static_cast<std::uint64_t>(std::int64_t{cells.bottom} - cells.top + 1);
+}
+
+
+
+
+// Empty for NaN bounds, clamped to [-max_cell, max_cell] otherwise (infinities included)
+inline auto VertexCuller::cells_of(sf::FloatRect const& rect) const noexcept -> Cell_range
+{
+    auto const right  = rect.left + rect.width;
+    auto const bottom = rect.top + rect.height;
+    if (std::isnan(rect.left) || std::isnan(rect.top) || std::isnan(right) || std::isnan(bottom)) {
+        return Cell_range{};
+    }
+
+    auto const cell = [this](float coordinate) {
+        auto const limit = static_cast<float>(max_cell);
+        return static_cast<std::int32_t>(std::clamp(std::floor(coordinate / m_cell_size), -limit, limit));
+    };
+    return {cell(rect.left), cell(rect.top), cell(right), cell(bottom)};
+}
+
+
+
+
+inline void VertexCuller::insert(std::uint32_t source, std::uint32_t primitive)
+{
+    auto& cells = m_sources[source].primitives[primitive].cells;
+    cells = cells_of(m_sources[source].primitives[primitive].bounds);
+
+    if (cell_count(cells) > max_cells_per_primitive) {
+        m_large.push_back({source, primitive});
+        return;
+    }
+    for (auto y = cells.top; y <= cells.bottom; ++y)
+    for (auto x = cells.left; x <= cells.right; ++x)
+        m_grid[cell_key(x, y)].push_back({source, primitive});
+}
+
+
+
+
+inline void VertexCuller::erase(std::uint32_t source, std::uint32_t primitive)
+{
+    auto& cells = m_sources[source].primitives[primitive].cells;
+    auto const matches = [&](Entry const& entry) {
+        return entry.source == source && entry.primitive == primitive;
+    };
+
+    if (cell_count(cells) > max_cells_per_primitive) {
+        auto const it = std::find_if(m_large.begin(), m_large.end(), matches);
+        if (it != m_large.end()) {
+            *it = m_large.back();
+            m_large.pop_back();
+        }
+        cells = Cell_range{};
+        return;
+    }
+    for (auto y = cells.top; y <= cells.bottom; ++y)
+    for (auto x = cells.left; x <= cells.right; ++x)
+    {
+        auto const cell = m_grid.find(cell_key(x, y));
+        if (cell == m_grid.end()) {
+            continue;
+        }
+        auto& entries = cell->second;
+        auto const it = std::find_if(entries.begin(), entries.end(), matches);
+        if (it != entries.end()) {
+            *it = entries.back();
+            entries.pop_back();
+        }
+    }
+    cells = Cell_range{};
+}
+
+
+
+
+inline void VertexCuller::compute_bounds(Source& source, std::size_t first, std::size_t last) const
+{
+    auto const* vertices = sf::contiguous_begin(*source.array);
+    auto const per_primitive = source.vertices_per_primitive;
+
+    auto const work = [&](std::size_t from, std::size_t to) {
+        for (auto i = from; i < to; ++i)
+        {
+            auto const* vertex = vertices + i * per_primitive;
+            float left = vertex->position.x, right = left;
+            float top  = vertex->position.y, bottom = top;
+            bool  nan  = std::isnan(vertex->position.x) || std::isnan(vertex->position.y);
+
+            for (std::size_t k=1; k < per_primitive; ++k) {
+                left   = std::min(left, vertex[k].position.x);
+                right  = std::max(right, vertex[k].position.x);
+                top    = std::min(top, vertex[k].position.y);
+                bottom = std::max(bottom, vertex[k].position.y);
+                nan    = nan || std::isnan(vertex[k].position.x) || std::isnan(vertex[k].position.y);
+            }
+            // std::min and std::max drop NaNs: keep them in the bounds, so that cells_of() skips them
+            if (nan) {
+                left = top = std::numeric_limits<float>::quiet_NaN();
+            }
+            source.primitives[i].bounds = {left, top, right - left, bottom - top};
+        }
+    };
+
+    auto const count   = last - first;
+    auto const threads = std::min<std::size_t>(std::thread::hardware_concurrency(), count / parallel_threshold + 1);
+
+    if (threads <= 1) {
+        work(first, last);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    for (std::size_t t=0; t < threads; ++t)
+        workers.emplace_back(work, first + count * t / threads, first + count * (t+1) / threads);
+    for (auto& worker : workers)
+        worker.join();
+}
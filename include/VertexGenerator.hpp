@@ -0,0 +1,506 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+    class VertexGenerator
+
+    This file defines a coroutine type producing `sf::Vertex` values one
+    at a time, in the style of C++23 `std::generator`, and injects in the
+    `sf` namespace a bulk sink and generators of common shapes:
+
+        VertexGenerator ring(sf::Vector2f center, float radius)
+        {
+            co_yield VertexGenerator::Size_hint{64};
+            for (int i=0; i < 64; ++i)
+                co_yield sf::Vertex{center + ...};
+        }
+
+        sf::append(va, ring(center, 10.f));
+        sf::append(va, sf::generate_bezier_stroke(...), [&](sf::Vertex const& v) {
+            return view.contains(v.position);   // stop at the first vertex off-screen
+        });
+
+    A generator is an input range: vertices are produced as they are
+    read, without an intermediate buffer, and generation stops as soon
+    as the consumer stops reading. A generator can announce the number of
+    vertices it will produce with `co_yield Size_hint{n}` before its first
+    vertex, so that the sink resizes the array once.
+
+    Requires C++20 (coroutines).
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#pragma once
+#if __cplusplus > 201703L
+#include <algorithm>
+#include <cmath>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <ranges>
+#include <utility>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/System/Vector2.hpp>
+#include "VertexArray_iterator.hpp"
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class VertexGenerator
+    move-only input range over the vertices yielded by a coroutine.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+class VertexGenerator
+{
+public:
+    // Yielded before the first vertex: number of vertices to come
+    struct Size_hint
+    {
+        std::size_t     count;
+    };
+
+    struct promise_type
+    {
+        sf::Vertex          value;
+        std::size_t         hint = 0;
+        std::exception_ptr  exception;
+
+        VertexGenerator get_return_object() noexcept
+        {
+            return VertexGenerator{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        std::suspend_always final_suspend() const noexcept { return {}; }
+
+        std::suspend_always yield_value(sf::Vertex const& vertex) noexcept
+        {
+            value = vertex;
+            return {};
+        }
+
+        std::suspend_never yield_value(Size_hint size) noexcept
+        {
+            hint = size.count;
+            return {};
+        }
+
+        void return_void() const noexcept {}
+        void unhandled_exception() noexcept { exception = std::current_exception(); }
+
+    };
+
+    class iterator;
+
+private:
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Handle      m_coroutine;
+
+    explicit VertexGenerator(Handle coroutine) noexcept;
+
+public:
+    VertexGenerator(VertexGenerator&&) noexcept;
+    VertexGenerator& operator=(VertexGenerator&&) noexcept;
+    ~VertexGenerator();
+
+    // Run up to the first vertex. Call once: a generator is a single-pass range
+    iterator                    begin();
+    std::default_sentinel_t     end() const noexcept;
+
+    // Vertex count announced by the coroutine, 0 if none. Known after begin()
+    std::size_t                 size_hint() const noexcept;
+
+};
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class VertexGenerator::iterator
+    input iterator, resuming the coroutine on increment.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+class VertexGenerator::iterator
+{
+public:
+    using value_type        = sf::Vertex;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = sf::Vertex const*;
+    using reference         = sf::Vertex const&;
+    using iterator_concept  = std::input_iterator_tag;
+
+private:
+    Handle      m_coroutine;
+
+public:
+    iterator() noexcept = default;
+    explicit iterator(Handle coroutine) noexcept : m_coroutine {coroutine} {}
+
+    reference operator*() const noexcept { return m_coroutine.promise().value; }
+    pointer operator->() const noexcept { return &m_coroutine.promise().value; }
+
+    iterator& operator++();
+    void      operator++(int) { ++*this; }
+
+    friend bool operator==(iterator const& it, std::default_sentinel_t) noexcept
+    {
+        return !it.m_coroutine || it.m_coroutine.done();
+    }
+
+};
+
+
+
+
+static_assert(std::input_iterator<VertexGenerator::iterator>);
+static_assert(std::ranges::input_range<VertexGenerator>);
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Sink and shape generators
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace sf
+{
+/**
+ *  Append the vertices of `generator` to `va`, resizing it once when
+ *  the generator gives a size hint.
+ *
+ *  @return the number of vertices appended
+ */
+std::size_t append(sf::VertexArray& va, VertexGenerator generator);
+
+/**
+ *  Same, stopping the generator at the first vertex for which
+ *  `keep(vertex)` is false. The vertices of an incomplete last primitive
+ *  (for the primitive type of `va`) are dropped.
+ */
+template <typename Predicate>
+std::size_t append(sf::VertexArray& va, VertexGenerator generator, Predicate keep);
+
+// Disc of `segments` triangles around `center`
+VertexGenerator generate_circle(
+    sf::Vector2f    center,
+    float           radius,
+    std::size_t     segments,
+    sf::Color       color = sf::Color::White
+);
+
+// Rectangle with corners rounded by `radius`, as triangles around its center
+VertexGenerator generate_rounded_rect(
+    sf::FloatRect   rect,
+    float           radius,
+    std::size_t     corner_segments,
+    sf::Color       color = sf::Color::White
+);
+
+// Cubic Bézier curve stroked `width` wide, as 2 triangles per segment
+VertexGenerator generate_bezier_stroke(
+    sf::Vector2f    p0,
+    sf::Vector2f    p1,
+    sf::Vector2f    p2,
+    sf::Vector2f    p3,
+    float           width,
+    std::size_t     segments,
+    sf::Color       color = sf::Color::White
+);
+
+} // namespace sf
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Impl.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace vertex_array::impl
+{
+// Vertices of an independent primitive, 1 for strips and fans
+inline std::size_t list_primitive_size(sf::PrimitiveType type) noexcept
+{
+    switch (type)
+    {
+        case sf::Lines:     return 2;
+        case sf::Triangles: return 3;
+        case sf::Quads:     return 4;
+        default:            return 1;
+    }
+}
+
+
+
+/**
+ *  Write the generated vertices past the end of `va`, growing it by the
+ *  size hint first, then by doubling, and trim it to the vertices written.
+ */
+template <typename Predicate>
+std::size_t append_generated(sf::VertexArray& va, VertexGenerator& generator, Predicate& keep, bool whole_primitives)
+{
+    auto const first = va.getVertexCount();
+    auto it = generator.begin();
+
+    auto size = first;
+    auto capacity = first + generator.size_hint();
+    va.resize(capacity);
+    sf::Vertex* out = sf::contiguous_begin(va);
+
+    try {
+        for (; it != generator.end(); ++it)
+        {
+            if (!keep(*it)) {
+                break;
+            }
+            if (size == capacity) {
+                // grow the appended part only, not the vertices already in `va`
+                capacity = first + std::max<std::size_t>(2 * (size - first), 64);
+                va.resize(capacity);
+                out = sf::contiguous_begin(va);
+            }
+            out[size++] = *it;
+        }
+    }
+    catch (...) {
+        va.resize(first);
+        throw;
+    }
+
+    if (whole_primitives) {
+        size -= (size - first) % list_primitive_size(va.getPrimitiveType());
+    }
+    va.resize(size);
+    return size - first;
+}
+
+
+
+inline sf::Vector2f bezier_point(
+    sf::Vector2f p0, sf::Vector2f p1, sf::Vector2f p2, sf::Vector2f p3, float t
+) noexcept
+{
+    auto const u = 1.f - t;
+    return p0 * (u*u*u) + p1 * (3.f*u*u*t) + p2 * (3.f*u*t*t) + p3 * (t*t*t);
+}
+
+
+
+// Unit normal of the curve at `t`
+inline sf::Vector2f bezier_normal(
+    sf::Vector2f p0, sf::Vector2f p1, sf::Vector2f p2, sf::Vector2f p3, float t
+) noexcept
+{
+    auto const u = 1.f - t;
+    auto const d = (p1 - p0) * (3.f*u*u) + (p2 - p1) * (6.f*u*t) + (p3 - p2) * (3.f*t*t);
+    auto const length = std::hypot(d.x, d.y);
+    return length > 0.f ? sf::Vector2f{-d.y / length, d.x / length} : sf::Vector2f{0.f, 0.f};
+}
+
+} // namespace vertex_array::impl
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    VertexGenerator implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+inline VertexGenerator::VertexGenerator(Handle coroutine) noexcept
+    : m_coroutine {coroutine}
+{
+}
+
+
+
+
+inline VertexGenerator::VertexGenerator(VertexGenerator&& other) noexcept
+    : m_coroutine {std::exchange(other.m_coroutine, {})}
+{
+}
+
+
+
+
+inline VertexGenerator& VertexGenerator::operator=(VertexGenerator&& other) noexcept
+{
+    if (this != &other) {
+        if (m_coroutine) {
+            m_coroutine.destroy();
+        }
+        m_coroutine = std::exchange(other.m_coroutine, {});
+    }
+    return *this;
+}
+
+
+
+
+inline VertexGenerator::~VertexGenerator()
+{
+    if (m_coroutine) {
+        m_coroutine.destroy();
+    }
+}
+
+
+
+
+inline VertexGenerator::iterator VertexGenerator::begin()
+{
+    if (m_coroutine) {
+        iterator it {m_coroutine};
+        return ++it;
+    }
+    return iterator{};
+}
+
+
+
+
+inline std::default_sentinel_t VertexGenerator::end() const noexcept
+{
+    return std::default_sentinel;
+}
+
+
+
+
+inline std::size_t VertexGenerator::size_hint() const noexcept
+{
+    return m_coroutine ? m_coroutine.promise().hint : 0;
+}
+
+
+
+
+inline VertexGenerator::iterator& VertexGenerator::iterator::operator++()
+{
+    m_coroutine.resume();
+    if (m_coroutine.promise().exception) {
+        std::rethrow_exception(std::exchange(m_coroutine.promise().exception, nullptr));
+    }
+    return *this;
+}
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Sink and shape generators implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace sf
+{
+inline std::size_t append(sf::VertexArray& va, VertexGenerator generator)
+{
+    auto const keep_all = [](sf::Vertex const&) noexcept { return true; };
+    return vertex_array::impl::append_generated(va, generator, keep_all, false);
+}
+
+
+
+
+template <typename Predicate>
+std::size_t append(sf::VertexArray& va, VertexGenerator generator, Predicate keep)
+{
+    return vertex_array::impl::append_generated(va, generator, keep, true);
+}
+
+
+
+
+inline VertexGenerator generate_circle(
+    sf::Vector2f    center,
+    float           radius,
+    std::size_t     segments,
+    sf::Color       color
+)
+{
+    co_yield VertexGenerator::Size_hint{segments * 3};
+
+    auto const step = 6.2831853f / static_cast<float>(segments);
+    sf::Vector2f previous {center.x + radius, center.y};
+    for (std::size_t i=1; i <= segments; ++i)
+    {
+        auto const angle = step * static_cast<float>(i % segments);
+        sf::Vector2f const next {center.x + radius * std::cos(angle), center.y + radius * std::sin(angle)};
+        co_yield sf::Vertex{center, color};
+        co_yield sf::Vertex{previous, color};
+        co_yield sf::Vertex{next, color};
+        previous = next;
+    }
+}
+
+
+
+
+inline VertexGenerator generate_rounded_rect(
+    sf::FloatRect   rect,
+    float           radius,
+    std::size_t     corner_segments,
+    sf::Color       color
+)
+{
+    auto const points = 4 * (corner_segments + 1);
+    co_yield VertexGenerator::Size_hint{points * 3};
+
+    radius = std::min({radius, rect.width / 2.f, rect.height / 2.f});
+    sf::Vector2f const center {rect.left + rect.width / 2.f, rect.top + rect.height / 2.f};
+    sf::Vector2f const half {rect.width / 2.f - radius, rect.height / 2.f - radius};
+
+    // perimeter point i: corners clockwise from the bottom right, each a quarter arc
+    auto const step = 1.5707963f / static_cast<float>(std::max<std::size_t>(corner_segments, 1));
+    auto const perimeter = [&](std::size_t i) {
+        auto const corner = i / (corner_segments + 1) % 4;
+        auto const angle  = 1.5707963f * static_cast<float>(corner) + step * static_cast<float>(i % (corner_segments + 1));
+        sf::Vector2f const arc_center {
+            center.x + (corner == 0 || corner == 3 ? half.x : -half.x),
+            center.y + (corner == 0 || corner == 1 ? half.y : -half.y)
+        };
+        return sf::Vector2f{arc_center.x + radius * std::cos(angle), arc_center.y + radius * std::sin(angle)};
+    };
+
+    for (std::size_t i=0; i < points; ++i)
+    {
+        co_yield sf::Vertex{center, color};
+        co_yield sf::Vertex{perimeter(i), color};
+        co_yield sf::Vertex{perimeter(i + 1), color};
+    }
+}
+
+
+
+
+inline VertexGenerator generate_bezier_stroke(
+    sf::Vector2f    p0,
+    sf::Vector2f    p1,
+    sf::Vector2f    p2,
+    sf::Vector2f    p3,
+    float           width,
+    std::size_t     segments,
+    sf::Color       color
+)
+{
+    using namespace vertex_array::impl;
+    co_yield VertexGenerator::Size_hint{segments * 6};
+
+    auto const half = width / 2.f;
+    auto point  = bezier_point(p0, p1, p2, p3, 0.f);
+    auto offset = bezier_normal(p0, p1, p2, p3, 0.f) * half;
+    for (std::size_t i=1; i <= segments; ++i)
+    {
+        auto const t = static_cast<float>(i) / static_cast<float>(segments);
+        auto const next_point  = bezier_point(p0, p1, p2, p3, t);
+        auto const next_offset = bezier_normal(p0, p1, p2, p3, t) * half;
+
+        co_yield sf::Vertex{point + offset, color};
+        co_yield sf::Vertex{point - offset, color};
+        co_yield sf::Vertex{next_point + next_offset, color};
+        co_yield sf::Vertex{next_point + next_offset, color};
+        co_yield sf::Vertex{point - offset, color};
+        co_yield sf::Vertex{next_point - next_offset, color};
+
+        point  = next_point;
+        offset = next_offset;
+    }
+}
+
+} // namespace sf
+
+#endif // C++20
@@ -0,0 +1,411 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+    class VertexSlotPool
+    struct VertexSlot_handle
+
+    This file defines an `sf::VertexArray` cut into fixed-size slots of
+    vertices (one quad per particle, for instance) that are spawned and
+    killed in O(1). spawn() returns a handle which stays valid until its
+    slot is killed, however the other slots move:
+
+        VertexSlotPool particles {sf::Quads, 4};
+        auto spark = particles.spawn();
+        if (sf::Vertex* quad = particles.get(spark))
+            quad[0].position = ...;
+        particles.kill(spark);
+        window.draw(particles.array());
+
+    The live slots are kept dense at the front of the array: kill() moves
+    the last slot into the hole. begin() and end() thus walk the live
+    vertices only, and the array can be drawn as is.
+
+    Handles carry a generation, so a handle to a killed slot is detected
+    even once its index is reused: get() returns nullptr, kill() false.
+    Pointers returned by get() are invalidated by spawn() and kill().
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include "VertexArray_iterator.hpp"
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    struct VertexSlot_handle
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+struct VertexSlot_handle
+{
+    std::uint32_t   index       = 0;
+    std::uint32_t   generation  = 0;    // 0 for a null handle
+
+    friend bool operator==(VertexSlot_handle lhs, VertexSlot_handle rhs) noexcept
+    {
+        return lhs.index == rhs.index && lhs.generation == rhs.generation;
+    }
+
+    friend bool operator!=(VertexSlot_handle lhs, VertexSlot_handle rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+};
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    class VertexSlotPool
+
+    Slots should hold whole primitives of a list type (Points, Lines,
+    Triangles, Quads): strip and fan primitives would run across slots.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+class VertexSlotPool
+{
+    // Entry of a handle index: its slot while alive, the next free index otherwise
+    struct Entry
+    {
+        std::uint32_t   slot_or_next;
+        std::uint32_t   generation;     // odd while alive
+    };
+
+    static constexpr std::uint32_t no_entry = ~std::uint32_t{0};
+
+    sf::VertexArray             m_array;
+    std::size_t                 m_slot_size;
+    std::vector<Entry>          m_entries;
+    std::vector<std::uint32_t>  m_owners;       // per live slot, index of its handle
+    std::uint32_t               m_free = no_entry;
+
+public:
+    explicit VertexSlotPool(sf::PrimitiveType = sf::Quads, std::size_t slot_size = 4);
+
+    // Allocate for `slots` live slots
+    void                        reserve(std::size_t slots);
+
+    //* Append a slot of default vertices. @return its handle
+    VertexSlot_handle           spawn();
+
+    //* Move the last slot into the slot of `handle`. @return false if the handle is stale
+    bool                        kill(VertexSlot_handle handle);
+
+    // Kill every slot, invalidating every handle
+    void                        clear();
+
+    bool                        valid(VertexSlot_handle handle) const noexcept;
+
+    // First vertex of the slot of `handle`, or nullptr if the handle is stale
+    sf::Vertex*                 get(VertexSlot_handle handle) noexcept;
+    sf::Vertex const*           get(VertexSlot_handle handle) const noexcept;
+
+    // Handle of the live slot at position `slot`, in [0, size())
+    VertexSlot_handle           handle(std::size_t slot) const noexcept;
+
+    // Live slots
+    std::size_t                 size() const noexcept;
+    bool                        empty() const noexcept;
+    std::size_t                 slot_size() const noexcept;
+
+    // The live vertices, to be drawn
+    sf::VertexArray const&      array() const noexcept;
+
+    VertexArray_iterator        begin() noexcept;
+    VertexArray_iterator        end() noexcept;
+    VertexArray_const_iterator  begin() const noexcept;
+    VertexArray_const_iterator  end() const noexcept;
+    VertexArray_const_iterator  cbegin() const noexcept;
+    VertexArray_const_iterator  cend() const noexcept;
+
+};
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Live vertices of a pool, as for an `sf::VertexArray`
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace sf
+{
+VertexArray_iterator                begin(VertexSlotPool&) noexcept;
+VertexArray_const_iterator          begin(VertexSlotPool const&) noexcept;
+VertexArray_const_iterator          cbegin(VertexSlotPool const&) noexcept;
+VertexArray_iterator                end(VertexSlotPool&) noexcept;
+VertexArray_const_iterator          end(VertexSlotPool const&) noexcept;
+VertexArray_const_iterator          cend(VertexSlotPool const&) noexcept;
+
+} // namespace sf
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    VertexSlotPool implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+inline VertexSlotPool::VertexSlotPool(sf::PrimitiveType type, std::size_t slot_size)
+    : m_array       {type}
+    , m_slot_size   {std::max<std::size_t>(slot_size, 1)}
+{
+}
+
+
+
+
+inline void VertexSlotPool::reserve(std::size_t slots)
+{
+    m_entries.reserve(slots);
+    m_owners.reserve(slots);
+
+    // sf::VertexArray has no reserve(), but shrinking keeps its capacity
+    if (slots > m_owners.size()) {
+        m_array.resize(slots * m_slot_size);
+        m_array.resize(m_owners.size() * m_slot_size);
+    }
+}
+
+
+
+
+inline VertexSlot_handle VertexSlotPool::spawn()
+{
+    auto const slot = static_cast<std::uint32_t>(m_owners.size());
+
+    std::uint32_t index;
+    if (m_free != no_entry) {
+        index = m_free;
+        m_free = m_entries[index].slot_or_next;
+    }
+    else {
+        index = static_cast<std::uint32_t>(m_entries.size());
+        m_entries.push_back(Entry{0, 0});
+    }
+
+    auto& entry = m_entries[index];
+    entry.slot_or_next = slot;
+    ++entry.generation;     // now odd, never the 0 of null handles
+
+    m_owners.push_back(index);
+    m_array.resize(m_owners.size() * m_slot_size);
+    return VertexSlot_handle{index, entry.generation};
+}
+
+
+
+
+inline bool VertexSlotPool::kill(VertexSlot_handle handle)
+{
+    if (!valid(handle)) {
+        return false;
+    }
+
+    auto& entry = m_entries[handle.index];
+    auto const slot = entry.slot_or_next;
+    auto const last = static_cast<std::uint32_t>(m_owners.size() - 1);
+
+    if (slot != last) {
+        sf::Vertex* const vertices = sf::contiguous_begin(m_array);
+        std::copy_n(vertices + last * m_slot_size, m_slot_size, vertices + slot * m_slot_size);
+        m_owners[slot] = m_owners[last];
+        m_entries[m_owners[slot]].slot_or_next = slot;
+    }
+    m_owners.pop_back();
+    m_array.resize(m_owners.size() * m_slot_size);
+
+    ++entry.generation;
+    entry.slot_or_next = m_free;
+    m_free = handle.index;
+    return true;
+}
+
+
+
+
+inline void VertexSlotPool::clear()
+{
+    for (auto const index : m_owners) {
+        auto& entry = m_entries[index];
+        ++entry.generation;
+        entry.slot_or_next = m_free;
+        m_free = index;
+    }
+    m_owners.clear();
+    m_array.clear();
+}
+
+
+
+
+inline bool VertexSlotPool::valid(VertexSlot_handle handle) const noexcept
+{
+    return handle.index < m_entries.size()
+        && handle.generation % 2 == 1
+        && m_entries[handle.index].generation == handle.generation;
+}
+
+
+
+
+inline sf::Vertex* VertexSlotPool::get(VertexSlot_handle handle) noexcept
+{
+    if (!valid(handle)) {
+        return nullptr;
+    }
+    return sf::contiguous_begin(m_array) + m_entries[handle.index].slot_or_next * m_slot_size;
+}
+
+
+
+
+inline sf::Vertex const* VertexSlotPool::get(VertexSlot_handle handle) const noexcept
+{
+    if (!valid(handle)) {
+        return nullptr;
+    }
+    return sf::contiguous_begin(m_array) + m_entries[handle.index].slot_or_next * m_slot_size;
+}
+
+
+
+
+inline VertexSlot_handle VertexSlotPool::handle(std::size_t slot) const noexcept
+{
+    auto const index = m_owners[slot];
+    return VertexSlot_handle{index, m_entries[index].generation};
+}
+
+
+
+
+inline std::size_t VertexSlotPool::size() const noexcept
+{
+    return m_owners.size();
+}
+
+
+
+
+inline bool VertexSlotPool::empty() const noexcept
+{
+    return m_owners.empty();
+}
+
+
+
+
+inline std::size_t VertexSlotPool::slot_size() const noexcept
+{
+    return m_slot_size;
+}
+
+
+
+
+inline sf::VertexArray const& VertexSlotPool::array() const noexcept
+{
+    return m_array;
+}
+
+
+
+
+inline VertexArray_iterator VertexSlotPool::begin() noexcept
+{
+    return sf::begin(m_array);
+}
+
+
+
+
+inline VertexArray_iterator VertexSlotPool::end() noexcept
+{
+    return sf::end(m_array);
+}
+
+
+
+
+inline VertexArray_const_iterator VertexSlotPool::begin() const noexcept
+{
+    return sf::begin(m_array);
+}
+
+
+
+
+inline VertexArray_const_iterator VertexSlotPool::end() const noexcept
+{
+    return sf::end(m_array);
+}
+
+
+
+
+inline VertexArray_const_iterator VertexSlotPool::cbegin() const noexcept
+{
+    return sf::cbegin(m_array);
+}
+
+
+
+
+inline VertexArray_const_iterator VertexSlotPool::cend() const noexcept
+{
+    return sf::cend(m_array);
+}
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    sf::begin() / sf::end() implementation
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace sf
+{
+inline VertexArray_iterator begin(VertexSlotPool& pool) noexcept
+{
+    return pool.begin();
+}
+
+
+
+
+inline VertexArray_const_iterator begin(VertexSlotPool const& pool) noexcept
+{
+    return pool.begin();
+}
+
+
+
+
+inline VertexArray_const_iterator cbegin(VertexSlotPool const& pool) noexcept
+{
+    return pool.cbegin();
+}
+
+
+
+
+inline VertexArray_iterator end(VertexSlotPool& pool) noexcept
+{
+    return pool.end();
+}
+
+
+
+
+inline VertexArray_const_iterator end(VertexSlotPool const& pool) noexcept
+{
+    return pool.end();
+}
+
+
+
+
+inline VertexArray_const_iterator cend(VertexSlotPool const& pool) noexcept
+{
+    return pool.cend();
+}
+
+} // namespace sf
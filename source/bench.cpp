@@ -0,0 +1,969 @@
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "CompressedVertexArray.hpp"
+#include "IndexedVertexArray.hpp"
+#include "SoftwareRasterizer.hpp"
+#include "TripleBufferedVertexArray.hpp"
+#include "VertexArrayBuilder.hpp"
+#include "VertexArrayFile.hpp"
+#include "VertexCuller.hpp"
+#include "VertexGenerator.hpp"
+#include "VertexSlotPool.hpp"
+#include "VertexArray_iterator.hpp"
+#include "VertexArray_merge.hpp"
+#include "VertexArray_reduce.hpp"
+#include "VertexArray_sort.hpp"
+#include "VertexArray_transform.hpp"
+#include "VertexArray_zip.hpp"
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    Traversal benchmarks
+
+    Every case walks an `sf::VertexArray` of `state.range(0)` vertices and
+    reports items/s, bytes/s and time per vertex. Build once with -O2 and
+    once with -O3 and compare the JSON reports:
+
+        bench --benchmark_out=bench.json --benchmark_out_format=json
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+namespace
+{
+sf::VertexArray make_array(std::size_t count)
+{
+    sf::VertexArray va {sf::Triangles, count};
+    std::mt19937 rng {42};
+    std::uniform_real_distribution<float> dist {0.f, 1024.f};
+
+    for (std::size_t i=0; i < count; ++i) {
+        va[i].position  = {dist(rng), dist(rng)};
+        va[i].texCoords = {dist(rng), dist(rng)};
+    }
+    return va;
+}
+
+
+
+
+void report(benchmark::State& state)
+{
+    auto const vertices = static_cast<std::int64_t>(state.iterations()) * state.range(0);
+
+    state.SetItemsProcessed(vertices);
+    state.SetBytesProcessed(vertices * static_cast<std::int64_t>(sizeof(sf::Vertex)));
+    state.counters["time/vertex"] = benchmark::Counter(
+        static_cast<double>(state.range(0)),
+        benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert
+    );
+#if defined(SF_VA_ITERATOR_CHECKED)
+    state.SetLabel("checked iterators");
+#elif defined(SF_VA_ITERATOR_PROFILE)
+    state.SetLabel("profiled iterators");
+#endif
+}
+
+
+
+
+void vertex_counts(benchmark::internal::Benchmark* bench)
+{
+    for (std::int64_t count = 1'000; count <= 10'000'000; count *= 10)
+        bench->Arg(count);
+}
+
+
+
+
+/**
+ *  The iterator as it was before the SF_VA_ITERATOR_CHECKED hooks: an
+ *  array pointer and an index, dereferenced through `va[i]`. Unchecked
+ *  builds of VertexArray_iterator must run BM_range_for as fast as this.
+ */
+struct Baseline_iterator
+{
+    sf::VertexArray*    array;
+    std::size_t         index;
+
+    sf::Vertex& operator*() const { return (*array)[index]; }
+    Baseline_iterator& operator++() { ++index; return *this; }
+    bool operator!=(Baseline_iterator const& other) const
+    {
+        return array != other.array || index != other.index;
+    }
+};
+
+} // namespace
+
+
+
+
+static void BM_index_loop(benchmark::State& state)
+{
+    auto va = make_array(state.range(0));
+
+    for (auto _ : state) {
+        for (std::size_t i=0; i < va.getVertexCount(); ++i)
+            va[i].position.x += 1.f;
+        benchmark::ClobberMemory();
+    }
+    report(state);
+}
+BENCHMARK(BM_index_loop)->Apply(vertex_counts);
+
+
+
+
+static void BM_contiguous_loop(benchmark::State& state)
+{
+    auto va = make_array(state.range(0));
+
+    for (auto _ : state) {
+        for (auto* it = sf::contiguous_begin(va); it != sf::contiguous_end(va); ++it)
+            it->position.x += 1.f;
+        benchmark::ClobberMemory();
+    }
+    report(state);
+}
+BENCHMARK(BM_contiguous_loop)->Apply(vertex_counts);
+
+
+
+
+static void BM_range_for(benchmark::State& state)
+{
+    auto va = make_array(state.range(0));
+
+    for (auto _ : state) {
+        for (auto& vertex : va)
+            vertex.position.x += 1.f;
+        benchmark::ClobberMemory();
+    }
+    report(state);
+}
+BENCHMARK(BM_range_for)->Apply(vertex_counts);
+
+
+
+
+static void BM_range_for_baseline(benchmark::State& state)
+{
+    auto va = make_array(state.range(0));
+
+    for (auto _ : state) {
+        Baseline_iterator const last {&va, va.getVertexCount()};
+        for (Baseline_iterator it {&va, 0}; it != last; ++it)
+            (*it).position.x += 1.f;
+        benchmark::ClobberMemory();
+    }
+    report(state);
+}
+BENCHMARK(BM_range_for_baseline)->Apply(vertex_counts);
+
+
+
+
+static void BM_reverse_loop(benchmark::State& state)
+{
+    auto va = make_array(state.range(0));
+
+    for (auto _ : state) {
+        std::for_each(sf::rbegin(va), sf::rend(va), [](sf::Vertex& vertex) {
+            vertex.position.x += 1.f;
+        });
+        benchmark::ClobberMemory();
+    }
+    report(state);
+}
+BENCHMARK(BM_reverse_loop)->Apply(vertex_counts);
+
+
+
+
+static void BM_transform(benchmark::State& state)
+{
+    auto va = make_array(state.range(0));
+
+    for (auto _ : state) {
+        std::transform(sf::begin(va), sf::end(va), sf::begin(va), [](sf::Vertex vertex) {
+            vertex.position.x *= 0.5f;
+            vertex.position.y *= 0.5f;
+            return vertex;
+        });
+        benchmark::ClobberMemory();
+    }
+    report(state);
+}
+BENCHMARK(BM_transform)->Apply(vertex_counts);
+
+
+
+
+static void BM_accumulate(benchmark::State& state)
+{
+    auto const va = make_array(state.range(0));
+
+    for (auto _ : state) {
+        auto sum = std::accumulate(sf::cbegin(va), sf::cend(va), 0.f,
+            [](float acc, sf::Vertex const& vertex) {
+                return acc + vertex.position.x;
+            });
+        benchmark::DoNotOptimize(sum);
+    }
+    report(state);
+}
+BENCHMARK(BM_accumulate)->Apply(vertex_counts);
+
+
+
+
+static void BM_sort_contiguous(benchmark::State& state)
+{
+    auto const source = make_array(state.range(0));
+    auto va = source;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        va = source;
+        state.ResumeTiming();
+        std::sort(sf::contiguous_begin(va), sf::contiguous_end(va),
+            [](sf::Vertex const& a, sf::Vertex const& b) {
+                return a.position.x < b.position.x;
+            });
+        benchmark::ClobberMemory();
+    }
+    report(state);
+}
+BENCHMARK(BM_sort_contiguous)->Apply(vertex_counts);
+
+
+
+
+static void BM_sort(benchmark::State& state)
+{
+    auto const source = make_array(state.range(0));
+    auto va = source;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        va = source;
+        state.ResumeTiming();
+        std::sort(sf::begin(va), sf::end(va),
+            [](sf::Vertex const& a, sf::Vertex const& b) {
+                return a.position.x < b.position.x;
+            });
+        benchmark::ClobberMemory();
+    }
+    report(state);
+}
+BENCHMARK(BM_sort)->Apply(vertex_counts);
+
+
+
+
+static void BM_transform_point_loop(benchmark::State& state)
+{
+    auto va = make_array(state.range(0));
+    sf::Transform transform;
+    transform.rotate(1.f);
+
+    for (auto _ : state) {
+        for (auto& vertex : va)
+            vertex.position = transform.transformPoint(vertex.position);
+        benchmark::ClobberMemory();
+    }
+    report(state);
+}
+BENCHMARK(BM_transform_point_loop)->Apply(vertex_counts);
+
+
+
+
+static void BM_apply_transform(benchmark::State& state)
+{
+    auto va = make_array(state.range(0));
+    sf::Transform transform;
+    transform.rotate(1.f);
+
+    for (auto _ : state) {
+        sf::apply_transform(va, transform);
+        benchmark::ClobberMemory();
+    }
+    report(state);
+}
+BENCHMARK(BM_apply_transform)->Apply(vertex_counts);
+
+
+
+
+static void BM_tint(benchmark::State& state)
+{
+    auto va = make_array(state.range(0));
+
+    for (auto _ : state) {
+        sf::tint(va, sf::Color{255, 254, 253, 252});
+        benchmark::ClobberMemory();
+    }
+    report(state);
+}
+BENCHMARK(BM_tint)->Apply(vertex_counts);
+
+
+
+
+static void BM_build_by_append(benchmark::State& state)
+{
+    auto const count = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state) {
+        sf::VertexArray va {sf::Quads};
+        for (std::size_t i=0; i < count; ++i)
+            va.append(sf::Vertex{{static_cast<float>(i), 0.f}});
+        benchmark::DoNotOptimize(&va[0]);
+    }
+    report(state);
+}
+BENCHMARK(BM_build_by_append)->Arg(100)->Arg(10'000);
+
+
+
+
+static void BM_build_with_builder(benchmark::State& state)
+{
+    auto const count = static_cast<std::size_t>(state.range(0));
+    VertexArrayBuilder builder;
+
+    for (auto _ : state) {
+        builder.clear();
+        for (std::size_t i=0; i < count; ++i)
+            builder.append(sf::Vertex{{static_cast<float>(i), 0.f}});
+        auto va = builder.build(sf::Quads);
+        benchmark::DoNotOptimize(&va[0]);
+    }
+    report(state);
+}
+BENCHMARK(BM_build_with_builder)->Arg(100)->Arg(10'000);
+
+
+
+
+// small triangles scattered over the scene, seen through a view covering 1/16th of it
+static void BM_cull(benchmark::State& state)
+{
+    auto va = make_array(static_cast<std::size_t>(state.range(0)));
+    for (std::size_t i=0; i + 2 < va.getVertexCount(); i += 3) {
+        va[i+1].position = va[i].position + sf::Vector2f{4.f, 0.f};
+        va[i+2].position = va[i].position + sf::Vector2f{0.f, 4.f};
+    }
+    VertexCuller culler {64.f};
+    culler.add(va);
+
+    sf::VertexArray visible {sf::Triangles};
+    for (auto _ : state) {
+        visible.clear();
+        culler.cull({384.f, 384.f, 256.f, 256.f}, sf::back_inserter(visible));
+        benchmark::DoNotOptimize(visible.getVertexCount());
+    }
+    report(state);
+}
+BENCHMARK(BM_cull)->Arg(10'002)->Arg(1'000'002);
+
+
+
+
+static void BM_getBounds(benchmark::State& state)
+{
+    auto const va = make_array(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(va.getBounds());
+    report(state);
+}
+BENCHMARK(BM_getBounds)->Apply(vertex_counts);
+
+
+
+
+static void BM_bounds(benchmark::State& state)
+{
+    auto const va = make_array(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(sf::bounds(va));
+    report(state);
+}
+BENCHMARK(BM_bounds)->Apply(vertex_counts)->UseRealTime();
+
+
+
+
+// baseline: one vertex per line, "x y r g b a u v"
+static void BM_load_text(benchmark::State& state)
+{
+    auto const va = make_array(static_cast<std::size_t>(state.range(0)));
+    auto const path = (std::filesystem::temp_directory_path() / "sf_va_bench.txt").string();
+    {
+        std::ofstream file {path};
+        for (auto const& v : sf::vertices(va)) {
+            file << v.position.x << ' ' << v.position.y << ' '
+                 << +v.color.r << ' ' << +v.color.g << ' ' << +v.color.b << ' ' << +v.color.a << ' '
+                 << v.texCoords.x << ' ' << v.texCoords.y << '\n';
+        }
+    }
+
+    for (auto _ : state) {
+        std::ifstream file {path};
+        sf::VertexArray loaded {sf::Triangles};
+        sf::Vertex v;
+        int r, g, b, a;
+        while (file >> v.position.x >> v.position.y >> r >> g >> b >> a >> v.texCoords.x >> v.texCoords.y) {
+            v.color = sf::Color(
+                static_cast<sf::Uint8>(r), static_cast<sf::Uint8>(g),
+                static_cast<sf::Uint8>(b), static_cast<sf::Uint8>(a));
+            loaded.append(v);
+        }
+        benchmark::DoNotOptimize(loaded.getVertexCount());
+    }
+    report(state);
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_load_text)->Arg(10'000)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+
+
+
+static void BM_load_file(benchmark::State& state)
+{
+    auto const va = make_array(static_cast<std::size_t>(state.range(0)));
+    auto const format = static_cast<VertexArrayFile_format>(state.range(1));
+    auto const path = (std::filesystem::temp_directory_path() / "sf_va_bench.sfva").string();
+    sf::save_vertices(va, path, format);
+
+    for (auto _ : state) {
+        VertexArrayFile file;
+        file.open(path);
+        sf::VertexArray loaded;
+        file.load(loaded);
+        benchmark::DoNotOptimize(loaded.getVertexCount());
+    }
+    report(state);
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_load_file)
+    ->ArgsProduct({{10'000, 1'000'000}, {0, 1}})
+    ->ArgNames({"vertices", "quantized"})
+    ->Unit(benchmark::kMillisecond);
+
+
+
+
+// decor-like content: few distinct colors and texture coordinates
+static void BM_compressed_iteration(benchmark::State& state)
+{
+    auto va = make_array(static_cast<std::size_t>(state.range(0)));
+    for (std::size_t i=0; i < va.getVertexCount(); ++i)
+        va[i].texCoords = {static_cast<float>(i % 4) * 32.f, 0.f};
+
+    CompressedVertexArray compressed;
+    compressed.encode(va);
+
+    for (auto _ : state) {
+        float sum = 0.f;
+        for (auto it = compressed.begin(); it != compressed.end(); ++it)
+            sum += (*it).position.x;
+        benchmark::DoNotOptimize(sum);
+    }
+    report(state);
+    state.counters["bytes/vertex"] = static_cast<double>(compressed.memory_size())
+                                   / static_cast<double>(compressed.getVertexCount());
+}
+BENCHMARK(BM_compressed_iteration)->Apply(vertex_counts);
+
+
+
+
+// sprites: quads keyed by texture page and depth
+namespace
+{
+sf::VertexArray make_sprites(std::size_t quads)
+{
+    sf::VertexArray va {sf::Quads, quads * 4};
+    std::mt19937 rng {42};
+    for (std::size_t q=0; q < quads; ++q) {
+        auto const page  = static_cast<float>(rng() % 8);
+        auto const depth = static_cast<sf::Uint8>(rng());
+        for (std::size_t v=0; v < 4; ++v) {
+            va[q*4 + v].texCoords = {page * 1024.f, 0.f};
+            va[q*4 + v].color.a   = depth;
+        }
+    }
+    return va;
+}
+
+std::uint32_t sprite_key(sf::Vertex const* quad)
+{
+    return static_cast<std::uint32_t>(quad[0].texCoords.x) / 1024 << 8 | quad[0].color.a;
+}
+
+} // namespace
+
+
+
+
+static void BM_sort_primitives_comparison(benchmark::State& state)
+{
+    auto const sprites = make_sprites(static_cast<std::size_t>(state.range(0)));
+    std::vector<std::uint32_t> order (static_cast<std::size_t>(state.range(0)));
+    std::vector<sf::Vertex> sorted (sprites.getVertexCount());
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto va = sprites;
+        state.ResumeTiming();
+
+        auto const* const quads = sf::contiguous_begin(va);
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(), [&](auto a, auto b) {
+            return sprite_key(quads + a*4) < sprite_key(quads + b*4);
+        });
+        for (std::size_t q=0; q < order.size(); ++q)
+            std::copy_n(quads + order[q]*4, 4, sorted.data() + q*4);
+        std::copy(sorted.begin(), sorted.end(), sf::contiguous_begin(va));
+        benchmark::DoNotOptimize(va[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_sort_primitives_comparison)->Arg(200'000)->Unit(benchmark::kMillisecond);
+
+
+
+
+static void BM_sort_primitives_radix(benchmark::State& state)
+{
+    auto const sprites = make_sprites(static_cast<std::size_t>(state.range(0)));
+    VertexArray_primitive_sorter<std::uint32_t> sorter;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto va = sprites;
+        state.ResumeTiming();
+
+        sorter.sort(va, sprite_key);
+        benchmark::DoNotOptimize(va[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_sort_primitives_radix)->Arg(200'000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+
+
+
+// scene graph batches: `state.range(0)` arrays of 400 vertices sharing a texture
+namespace
+{
+std::vector<sf::VertexArray> make_batches(std::size_t count)
+{
+    std::vector<sf::VertexArray> batches (count, make_array(400));
+    for (auto& batch : batches)
+        batch.setPrimitiveType(sf::Quads);
+    return batches;
+}
+
+std::vector<sf::Transform> make_transforms(std::size_t count)
+{
+    std::vector<sf::Transform> transforms (count);
+    for (std::size_t i=0; i < count; ++i)
+        transforms[i].translate(static_cast<float>(i), 0.f);
+    return transforms;
+}
+
+} // namespace
+
+
+
+
+static void BM_merge_by_append(benchmark::State& state)
+{
+    auto const batches    = make_batches(static_cast<std::size_t>(state.range(0)));
+    auto const transforms = make_transforms(batches.size());
+    sf::VertexArray out {sf::Quads};
+
+    for (auto _ : state) {
+        out.clear();
+        for (std::size_t b=0; b < batches.size(); ++b)
+            for (std::size_t i=0; i < batches[b].getVertexCount(); ++i) {
+                auto vertex = batches[b][i];
+                vertex.position = transforms[b].transformPoint(vertex.position);
+                out.append(vertex);
+            }
+        benchmark::DoNotOptimize(out[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 400);
+}
+BENCHMARK(BM_merge_by_append)->Arg(100)->Arg(1'000);
+
+
+
+
+static void BM_merge(benchmark::State& state)
+{
+    auto const batches    = make_batches(static_cast<std::size_t>(state.range(0)));
+    auto const transforms = make_transforms(batches.size());
+    sf::VertexArray out {sf::Quads};
+
+    for (auto _ : state) {
+        auto const table = sf::merge(batches.begin(), batches.end(), transforms.begin(), out);
+        benchmark::DoNotOptimize(table.vertex_count());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 400);
+}
+BENCHMARK(BM_merge)->Arg(100)->Arg(1'000)->UseRealTime();
+
+
+
+
+// keyframe morphing: blend the positions of two arrays into a third one
+static void BM_morph_index_loop(benchmark::State& state)
+{
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto const a = make_array(count);
+    auto const b = make_array(count);
+    sf::VertexArray out {sf::Triangles, count};
+
+    for (auto _ : state) {
+        for (std::size_t i=0; i < count; ++i)
+            out[i].position = a[i].position + (b[i].position - a[i].position) * 0.5f;
+        benchmark::DoNotOptimize(out[0]);
+    }
+    report(state);
+}
+BENCHMARK(BM_morph_index_loop)->Arg(10'000)->Arg(300'000);
+
+
+
+
+static void BM_morph_zip(benchmark::State& state)
+{
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto const a = make_array(count);
+    auto const b = make_array(count);
+    sf::VertexArray out {sf::Triangles, count};
+
+    for (auto _ : state) {
+        for (auto [va, vb, vo] : sf::zip(a, b, out))
+            vo.position = va.position + (vb.position - va.position) * 0.5f;
+        benchmark::DoNotOptimize(out[0]);
+    }
+    report(state);
+}
+BENCHMARK(BM_morph_zip)->Arg(10'000)->Arg(300'000);
+
+
+
+
+static void BM_lerp_positions(benchmark::State& state)
+{
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto const a = make_array(count);
+    auto const b = make_array(count);
+    sf::VertexArray out {sf::Triangles, count};
+
+    for (auto _ : state) {
+        sf::lerp_positions(sf::zip(a, b, out), 0.5f);
+        benchmark::DoNotOptimize(out[0]);
+    }
+    report(state);
+}
+BENCHMARK(BM_lerp_positions)->Arg(10'000)->Arg(300'000);
+
+
+
+
+// simulation to render thread handoff of a frame where 1% of the vertices
+// moved, in runs of 100 (entities)
+static void BM_handoff_mutex_copy(benchmark::State& state)
+{
+    auto simulated = make_array(static_cast<std::size_t>(state.range(0)));
+    sf::VertexArray rendered;
+    std::mutex mutex;
+
+    for (auto _ : state) {
+        for (std::size_t first=0; first < simulated.getVertexCount(); first += 10'000)
+            for (std::size_t i=first; i < first + 100; ++i)
+                simulated[i].position.x += 1.f;
+        std::lock_guard<std::mutex> lock {mutex};
+        rendered = simulated;
+        benchmark::DoNotOptimize(rendered[0]);
+    }
+    report(state);
+}
+BENCHMARK(BM_handoff_mutex_copy)->Arg(200'000);
+
+
+
+
+static void BM_handoff_triple_buffer(benchmark::State& state)
+{
+    auto const count = static_cast<std::size_t>(state.range(0));
+    TripleBufferedVertexArray frames {sf::Triangles, count};
+
+    for (auto _ : state) {
+        for (std::size_t first=0; first < count; first += 10'000) {
+            for (std::size_t i=first; i < first + 100; ++i)
+                frames.back()[i].position.x += 1.f;
+            frames.mark_dirty(first, first + 100);
+        }
+        frames.publish();
+        frames.acquire();
+        benchmark::DoNotOptimize(frames.front()[0]);
+    }
+    report(state);
+}
+BENCHMARK(BM_handoff_triple_buffer)->Arg(200'000);
+
+
+
+
+// tilemap: grid of quads 256 tiles wide sharing their corners, over a
+// repeated texture
+namespace
+{
+sf::VertexArray make_tilemap(std::size_t vertices)
+{
+    sf::VertexArray va {sf::Quads};
+    for (std::size_t tile=0; tile < vertices / 4; ++tile) {
+        auto const x = static_cast<float>(tile % 256);
+        auto const y = static_cast<float>(tile / 256);
+        for (auto [dx, dy] : {std::pair{0.f, 0.f}, {1.f, 0.f}, {1.f, 1.f}, {0.f, 1.f}}) {
+            sf::Vector2f const corner {(x + dx) * 32.f, (y + dy) * 32.f};
+            va.append(sf::Vertex{corner, corner});
+        }
+    }
+    return va;
+}
+
+} // namespace
+
+
+
+
+static void BM_transform_tilemap(benchmark::State& state)
+{
+    auto va = make_tilemap(static_cast<std::size_t>(state.range(0)));
+    sf::Transform camera;
+    camera.translate(0.5f, -0.25f);
+
+    for (auto _ : state) {
+        sf::apply_transform(va, camera);
+        benchmark::DoNotOptimize(va[0]);
+    }
+    report(state);
+    state.counters["bytes/vertex"] = static_cast<double>(sizeof(sf::Vertex));
+}
+BENCHMARK(BM_transform_tilemap)->Arg(40'000)->Arg(4'000'000);
+
+
+
+
+static void BM_transform_tilemap_indexed(benchmark::State& state)
+{
+    IndexedVertexArray<> tiles;
+    tiles.encode(make_tilemap(static_cast<std::size_t>(state.range(0))));
+    sf::Transform camera;
+    camera.translate(0.5f, -0.25f);
+
+    for (auto _ : state) {
+        sf::apply_transform(tiles.data(), tiles.data() + tiles.unique_count(), camera);
+        benchmark::DoNotOptimize(tiles.data()[0]);
+    }
+    report(state);
+    state.counters["bytes/vertex"] = static_cast<double>(tiles.memory_size())
+                                   / static_cast<double>(tiles.getVertexCount());
+}
+BENCHMARK(BM_transform_tilemap_indexed)->Arg(40'000)->Arg(4'000'000);
+
+
+
+
+// particles: every frame, 1% of the quads die and as many spawn
+static void BM_particles_erase(benchmark::State& state)
+{
+    auto const quads = static_cast<std::size_t>(state.range(0));
+    std::vector<sf::Vertex> particles(quads * 4);
+    std::mt19937 rng {42};
+
+    for (auto _ : state) {
+        for (std::size_t i=0; i < quads / 100; ++i) {
+            auto const dead = particles.begin() + static_cast<std::ptrdiff_t>(rng() % quads * 4);
+            particles.erase(dead, dead + 4);
+            particles.insert(particles.end(), 4, sf::Vertex{});
+        }
+        benchmark::DoNotOptimize(particles.data());
+    }
+    report(state);
+}
+BENCHMARK(BM_particles_erase)->Arg(100'000)->Unit(benchmark::kMillisecond);
+
+
+
+
+static void BM_particles_slot_pool(benchmark::State& state)
+{
+    auto const quads = static_cast<std::size_t>(state.range(0));
+    VertexSlotPool particles {sf::Quads, 4};
+    std::vector<VertexSlot_handle> handles(quads);
+    for (auto& handle : handles)
+        handle = particles.spawn();
+    std::mt19937 rng {42};
+
+    for (auto _ : state) {
+        for (std::size_t i=0; i < quads / 100; ++i) {
+            auto& handle = handles[rng() % quads];
+            particles.kill(handle);
+            handle = particles.spawn();
+        }
+        benchmark::DoNotOptimize(particles.array()[0]);
+    }
+    report(state);
+}
+BENCHMARK(BM_particles_slot_pool)->Arg(100'000)->Unit(benchmark::kMillisecond);
+
+
+
+
+#if __cplusplus > 201703L
+// stroke tessellation: state.range(0) vertices, 6 per curve segment
+static void BM_stroke_eager(benchmark::State& state)
+{
+    using namespace vertex_array::impl;
+    auto const segments = static_cast<std::size_t>(state.range(0)) / 6;
+    sf::Vector2f const p0 {0.f, 0.f}, p1 {300.f, 900.f}, p2 {700.f, -500.f}, p3 {1000.f, 400.f};
+    sf::VertexArray va {sf::Triangles};
+
+    for (auto _ : state) {
+        std::vector<sf::Vertex> tessellated;
+        for (std::size_t i=0; i < segments; ++i) {
+            auto const t0 = static_cast<float>(i) / static_cast<float>(segments);
+            auto const t1 = static_cast<float>(i + 1) / static_cast<float>(segments);
+            auto const a = bezier_point(p0, p1, p2, p3, t0), b = bezier_point(p0, p1, p2, p3, t1);
+            auto const na = bezier_normal(p0, p1, p2, p3, t0) * 2.f, nb = bezier_normal(p0, p1, p2, p3, t1) * 2.f;
+            for (auto position : {a + na, a - na, b + nb, b + nb, a - na, b - nb})
+                tessellated.push_back(sf::Vertex{position});
+        }
+        va.clear();
+        for (auto const& vertex : tessellated)
+            va.append(vertex);
+        benchmark::DoNotOptimize(va[0]);
+    }
+    report(state);
+}
+BENCHMARK(BM_stroke_eager)->Arg(60'000)->Arg(6'000'000)->Unit(benchmark::kMillisecond);
+
+
+
+
+static void BM_stroke_generator(benchmark::State& state)
+{
+    auto const segments = static_cast<std::size_t>(state.range(0)) / 6;
+    sf::VertexArray va {sf::Triangles};
+
+    for (auto _ : state) {
+        va.clear();
+        sf::append(va, sf::generate_bezier_stroke({0.f, 0.f}, {300.f, 900.f}, {700.f, -500.f}, {1000.f, 400.f}, 4.f, segments));
+        benchmark::DoNotOptimize(va[0]);
+    }
+    report(state);
+}
+BENCHMARK(BM_stroke_generator)->Arg(60'000)->Arg(6'000'000)->Unit(benchmark::kMillisecond);
+#endif
+
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    End-to-end frame
+
+    A frame of sprites goes through the whole vertex pipeline, down to
+    SoftwareRasterizer instead of a GPU: generate the sprite quads, move
+    them by the camera, cull them to the view, sort them by texture page
+    and draw them. Each stage reports the vertices it processes per
+    second (e.g. `cull/s`), so that a regression in one feature shows up
+    even when another stage dominates the frame.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void BM_pipeline(benchmark::State& state)
+{
+    using clock = std::chrono::steady_clock;
+    enum Stage { generate, transform, cull, sort, draw, stage_count };
+    char const* const names[stage_count] = {"generate/s", "transform/s", "cull/s", "sort/s", "draw/s"};
+
+    auto const quads = static_cast<std::size_t>(state.range(0));
+    sf::VertexArray scene {sf::Quads, quads * 4};
+    std::mt19937 rng {42};
+    std::uniform_real_distribution<float> dist {0.f, 4096.f};
+    auto const generate_sprites = [&] {
+        sf::Vertex* vertex = sf::contiguous_begin(scene);
+        for (std::size_t q=0; q < quads; ++q) {
+            sf::Vector2f const corner {dist(rng), dist(rng)};
+            auto const page = static_cast<float>(rng() % 8) * 1024.f;
+            *vertex++ = sf::Vertex{corner, {page, 0.f}};
+            *vertex++ = sf::Vertex{corner + sf::Vector2f{16.f, 0.f}, {page + 16.f, 0.f}};
+            *vertex++ = sf::Vertex{corner + sf::Vector2f{16.f, 16.f}, {page + 16.f, 16.f}};
+            *vertex++ = sf::Vertex{corner + sf::Vector2f{0.f, 16.f}, {page, 16.f}};
+        }
+    };
+
+    // index a spread out frame: the culler erases entries cell by cell
+    generate_sprites();
+    VertexCuller culler {256.f};
+    auto const source = culler.add(scene);
+    sf::VertexArray visible {sf::Quads};
+    SoftwareRasterizer target {1280, 720};
+
+    sf::Transform camera;
+    camera.translate(-1024.f, -1024.f);
+
+    double seconds[stage_count] = {};
+    double vertices[stage_count] = {};
+    auto const timed = [&](Stage stage, std::size_t count, auto&& run) {
+        auto const start = clock::now();
+        run();
+        seconds[stage] += std::chrono::duration<double>(clock::now() - start).count();
+        vertices[stage] += static_cast<double>(count);
+    };
+
+    for (auto _ : state) {
+        timed(generate, quads * 4, generate_sprites);
+        timed(transform, quads * 4, [&] { sf::apply_transform(scene, camera); });
+        timed(cull, quads * 4, [&] {
+            culler.rebuild(source);
+            visible.clear();
+            culler.cull({0.f, 0.f, 1280.f, 720.f}, sf::back_inserter(visible));
+        });
+        timed(sort, visible.getVertexCount(), [&] { sf::sort_primitives(visible, sprite_key); });
+        timed(draw, visible.getVertexCount(), [&] {
+            target.clear();
+            target.draw(visible);
+        });
+        benchmark::DoNotOptimize(target.stats().fragments);
+    }
+    report(state);
+    for (int stage=0; stage < stage_count; ++stage)
+        state.counters[names[stage]] = vertices[stage] / seconds[stage];
+    state.counters["fragments"] = static_cast<double>(target.stats().fragments);
+}
+BENCHMARK(BM_pipeline)->Arg(10'000)->Arg(100'000)->Unit(benchmark::kMillisecond);
+
+
+
+
+BENCHMARK_MAIN();
@@ -1,25 +1,178 @@
 #include <SFML/Graphics/Vertex.hpp>
 #include <SFML/Graphics/VertexArray.hpp>
+#include <algorithm>
+#if __has_include(<execution>)
+#include <execution>
+#include <filesystem>
+#endif
+#include <cmath>
 #include <iostream>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <utility>
 
+#include "CompressedVertexArray.hpp"
+#include "IndexedVertexArray.hpp"
+#include "SoftwareRasterizer.hpp"
+#include "SoAVertexBuffer.hpp"
+#include "TripleBufferedVertexArray.hpp"
+#include "VertexArrayBuilder.hpp"
+#include "VertexArrayFile.hpp"
 #include "VertexArray_iterator.hpp"
+#include "VertexArray_parallel.hpp"
+#include "VertexArray_primitive.hpp"
+#include "VertexArray_merge.hpp"
+#include "VertexArray_reduce.hpp"
+#include "VertexArray_sort.hpp"
+#include "VertexArray_tracking.hpp"
+#include "VertexArray_transform.hpp"
+#include "VertexArray_view.hpp"
+#include "VertexArray_zip.hpp"
+#include "VertexCuller.hpp"
+#include "VertexGenerator.hpp"
+#include "VertexSlotPool.hpp"
 #include "test-tool.hpp"
+#ifdef SF_VA_ITERATOR_PROFILE
+#include <atomic>
+#include <sstream>
+#include <thread>
+#include "VertexArray_profile.hpp"
+#endif
+#ifdef SF_VA_ITERATOR_CHECKED
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 
 void test_iterator();
 void test_const_iterator();
+void test_contiguous_range();
+void test_algorithms();
+void test_iterator_properties();
+void test_view();
+void test_bulk_operations();
+void test_parallel();
+void test_soa_buffer();
+void test_dirty_tracking();
+void test_primitive_iterator();
+void test_builder();
+void test_culler();
+void test_reduce();
+void test_file();
+void test_compressed();
+void test_sort_primitives();
+void test_merge();
+void test_zip();
+void test_triple_buffer();
+void test_indexed();
+void test_slot_pool();
+void test_generator();
+void test_rasterizer();
+#ifdef SF_VA_ITERATOR_PROFILE
+void test_profile();
+#endif
+#ifdef SF_VA_ITERATOR_CHECKED
+void test_checked_iterators();
+
+// The iterator tests step out of range on purpose: record failures instead of aborting
+char const* last_check_failure = nullptr;
+void record_check_failure(char const* what) noexcept { last_check_failure = what; }
+#endif
 
 
 
 int main()
 {
     std::boolalpha(std::cerr);
+#ifdef SF_VA_ITERATOR_CHECKED
+    vertex_array::impl::iterator_check_handler = record_check_failure;
+#endif
 
     std::cerr << "test sf::VertexArray's iterator\n";
     test_iterator();
 
     std::cerr << "test sf::VertexArray's const_iterator\n";
     test_const_iterator();
+
+    std::cerr << "test sf::VertexArray's contiguous range\n";
+    test_contiguous_range();
+
+    std::cerr << "test standard algorithms on sf::VertexArray's iterators\n";
+    test_algorithms();
+
+    std::cerr << "test iterator laws against std::vector iterators\n";
+    test_iterator_properties();
+
+    std::cerr << "test sf::vertices() view\n";
+    test_view();
+
+    std::cerr << "test bulk operations\n";
+    test_bulk_operations();
+
+    std::cerr << "test parallel iteration\n";
+    test_parallel();
+
+    std::cerr << "test structure-of-arrays buffer\n";
+    test_soa_buffer();
+
+    std::cerr << "test dirty-range tracking\n";
+    test_dirty_tracking();
+
+    std::cerr << "test primitive iterators\n";
+    test_primitive_iterator();
+
+    std::cerr << "test VertexArrayBuilder\n";
+    test_builder();
+
+    std::cerr << "test VertexCuller\n";
+    test_culler();
+
+    std::cerr << "test reductions\n";
+    test_reduce();
+
+    std::cerr << "test binary vertex files\n";
+    test_file();
+
+    std::cerr << "test CompressedVertexArray\n";
+    test_compressed();
+
+    std::cerr << "test primitive radix sort\n";
+    test_sort_primitives();
+
+    std::cerr << "test batch merge\n";
+    test_merge();
+
+    std::cerr << "test zip iterator and blending kernels\n";
+    test_zip();
+
+    std::cerr << "test triple-buffered array\n";
+    test_triple_buffer();
+
+    std::cerr << "test IndexedVertexArray\n";
+    test_indexed();
+
+    std::cerr << "test VertexSlotPool\n";
+    test_slot_pool();
+
+    std::cerr << "test coroutine vertex generators\n";
+    test_generator();
+
+    std::cerr << "test software rasterizer\n";
+    test_rasterizer();
+
+#ifdef SF_VA_ITERATOR_CHECKED
+    std::cerr << "test checked iterators\n";
+    test_checked_iterators();
+#endif
+
+#ifdef SF_VA_ITERATOR_PROFILE
+    std::cerr << "test iterator profiling\n";
+    test_profile();
+#endif
 }
 
 
@@ -169,3 +322,1762 @@ void test_const_iterator()
         return count == va.getVertexCount();
     })(), "range-for loop iterates [VA's size] times");
 }
+
+
+
+
+void test_contiguous_range()
+{
+    sf::VertexArray va;
+
+    std::cerr << "--- Array is empty\n";
+    ENSURE(sf::contiguous_begin(va) == sf::contiguous_end(va), "empty VA contiguous begin and end are equal");
+    ENSURE(sf::contiguous_begin(std::as_const(va)) == sf::contiguous_end(std::as_const(va)),
+        "empty VA const contiguous begin and end are equal");
+
+    va.append({}); va[0].position.x = 0;
+    va.append({}); va[1].position.x = 1;
+    va.append({}); va[2].position.x = 2;
+    std::cerr << "\n--- Array has 3 elements now\n";
+
+    ENSURE(sf::contiguous_end(va) - sf::contiguous_begin(va) == (std::ptrdiff_t)va.getVertexCount(),
+        "contiguous end - begin should be VA's size");
+    ENSURE(sf::contiguous_begin(va) == &*sf::begin(va), "contiguous begin points to first vertex");
+    ENSURE(sf::contiguous_begin(std::as_const(va)) + 2 == &*(sf::cbegin(va) + 2),
+        "const contiguous begin + 2 points to third vertex");
+
+    for (auto* it = sf::contiguous_begin(va); it != sf::contiguous_end(va); ++it)
+        it->position.y = it->position.x;
+
+    ENSURE(([&]
+    {
+        std::vector<sf::Vertex> copy(va.getVertexCount());
+        std::copy(sf::contiguous_begin(std::as_const(va)), sf::contiguous_end(std::as_const(va)), copy.begin());
+        return std::equal(copy.begin(), copy.end(), sf::cbegin(va), [](auto const& a, auto const& b) {
+            return a.position.x == b.position.x && a.position.y == b.position.y;
+        });
+    })(), "std::copy through contiguous range copies every vertex");
+    ENSURE(va[2].position.y == 2, "writes through contiguous range reach the VA");
+}
+
+
+
+
+void test_algorithms()
+{
+    sf::VertexArray va;
+    for (float x : {3.f, 1.f, 4.f, 1.f, 5.f, 9.f, 2.f, 6.f})
+        va.append(sf::Vertex{{x, 0.f}});
+
+    auto const by_x = [](sf::Vertex const& a, sf::Vertex const& b) {
+        return a.position.x < b.position.x;
+    };
+
+    ENSURE(([&]{ auto it = sf::begin(va); auto old = it++; return old == sf::begin(va); })(),
+        "post-increment returns the previous position");
+    ENSURE(([&]{ auto it = sf::end(va); --it; return it == sf::begin(va) + 7; })(),
+        "pre-decrement moves one step back");
+    ENSURE(([&]{ auto it = sf::end(va); auto old = it--; return old == sf::end(va) && it == sf::end(va) - 1; })(),
+        "post-decrement returns the previous position and moves back");
+    ENSURE(sf::end(va) > sf::begin(va) && !(sf::begin(va) > sf::end(va)), "end > begin");
+    ENSURE((sf::begin(va) + 2)[1].position.x == 1.f, "subscript is relative to the iterator");
+    ENSURE(2 + sf::begin(va) == sf::begin(va) + 2, "n + it == it + n");
+    ENSURE((*sf::rbegin(va)).position.x == 6.f, "rbegin dereferences to the last vertex");
+    ENSURE((sf::crbegin(va) + 1)[1].position.x == 9.f, "reverse subscript is relative to the iterator");
+
+    std::sort(sf::begin(va), sf::end(va), by_x);
+    ENSURE(std::is_sorted(sf::cbegin(va), sf::cend(va), by_x), "std::sort sorts the VA");
+    ENSURE(std::lower_bound(sf::cbegin(va), sf::cend(va), sf::Vertex{{4.f, 0.f}}, by_x) == sf::cbegin(va) + 4,
+        "std::lower_bound finds the first vertex not less than the key");
+
+    std::sort(sf::rbegin(va), sf::rend(va), by_x);
+    ENSURE(std::is_sorted(sf::crbegin(va), sf::crend(va), by_x), "std::sort through reverse iterators");
+    ENSURE(va[0].position.x == 9.f, "reverse sort leaves the VA in descending order");
+
+#if __cplusplus > 201703L
+    std::ranges::sort(sf::begin(va), sf::end(va), by_x);
+    ENSURE(std::ranges::is_sorted(sf::cbegin(va), sf::cend(va), by_x), "std::ranges::sort sorts the VA");
+
+    std::vector<sf::Vertex> copy(va.getVertexCount());
+    std::ranges::copy(sf::cbegin(va), sf::cend(va), copy.begin());
+    ENSURE(std::to_address(sf::cend(va)) == sf::contiguous_end(va), "std::to_address of end is past the last vertex");
+    ENSURE(copy.back().position.x == 9.f, "std::ranges::copy copies every vertex");
+#endif
+}
+
+
+
+
+namespace
+{
+/**
+ *  Apply `steps` random moves to two iterators over [first, last) and to
+ *  their oracle counterparts over a std::vector holding the same vertices,
+ *  checking the random-access iterator laws after every move.
+ *
+ *  @return number of broken laws
+ */
+template <typename It, typename Oracle_it>
+std::size_t check_iterator_laws(
+    It              first,
+    It              last,
+    Oracle_it       oracle_first,
+    std::mt19937&   rng,
+    std::size_t     steps
+){
+    using diff_t = std::ptrdiff_t;
+    auto const size = last - first;
+    std::size_t failures = 0;
+    auto const check = [&](bool law) { failures += law ? 0 : 1; };
+
+    std::uniform_int_distribution<diff_t> any_index {0, size};
+    auto a = first, b = first;
+    auto oa = oracle_first, ob = oracle_first;
+
+    for (std::size_t step=0; step < steps; ++step)
+    {
+        auto const i = a - first;
+        auto const n = std::uniform_int_distribution<diff_t>{-i, size - i}(rng);
+
+        switch (rng() % 10) {
+            case 0: if (i < size) { ++a; ++oa; } break;
+            case 1: if (i > 0) { --a; --oa; } break;
+            case 2: if (i < size) { auto old = a++; oa++; check(old + 1 == a); } break;
+            case 3: if (i > 0) { auto old = a--; oa--; check(old - 1 == a); } break;
+            case 4: a += n; oa += n; break;
+            case 5: a -= -n; oa -= -n; break;
+            case 6: a = n + a; oa = n + oa; break;
+            case 7: a = std::next(a, n); oa = std::next(oa, n); break;
+            case 8: std::swap(a, b); std::swap(oa, ob); break;
+            case 9: b = first + any_index(rng); ob = oracle_first + (b - first); break;
+        }
+
+        auto const j = a - first;
+        auto const m = std::uniform_int_distribution<diff_t>{-j, size - j}(rng);
+
+        check(j == oa - oracle_first);
+        check(b - a == ob - oa);
+        check(std::distance(a, b) == b - a);
+        check(a + (b - a) == b);
+        check((a + m) - m == a && a + m == m + a && (a + m) - a == m);
+        check(std::prev(std::next(a, m), m) == a);
+        check((a == b) == (oa == ob) && (a != b) == (oa != ob));
+        check((a < b) == (oa < ob) && (a > b) == (oa > ob));
+        check((a <= b) == (oa <= ob) && (a >= b) == (oa >= ob));
+        check((a < b) == (b > a) && (a <= b) == !(b < a));
+
+        if (j < size) {
+            check((*a).position.x == (*oa).position.x);
+            check(a->position.x == oa->position.x);
+        }
+        if (size > 0) {
+            auto const k = std::uniform_int_distribution<diff_t>{0, size - 1}(rng);
+            check(a[k - j].position.x == oracle_first[k].position.x);
+        }
+    }
+    return failures;
+}
+
+
+
+
+std::vector<float> positions_x(sf::VertexArray const& va)
+{
+    std::vector<float> xs;
+    for (auto const& v : va)
+        xs.push_back(v.position.x);
+    return xs;
+}
+
+
+
+
+std::vector<float> positions_x(std::vector<sf::Vertex> const& vertices)
+{
+    std::vector<float> xs;
+    for (auto const& v : vertices)
+        xs.push_back(v.position.x);
+    return xs;
+}
+
+} // namespace
+
+
+
+
+void test_iterator_properties()
+{
+    constexpr std::size_t arrays = 1'000;
+    constexpr std::size_t steps  = 1'000;   // per array and iterator type
+
+    std::mt19937 rng {20240601};
+    std::size_t iterator_failures = 0;
+    std::size_t reverse_failures = 0;
+
+    for (std::size_t round=0; round < arrays; ++round)
+    {
+        sf::VertexArray va {sf::Points, rng() % 100};
+        for (std::size_t i=0; i < va.getVertexCount(); ++i)
+            va[i].position.x = static_cast<float>(i);
+
+        std::vector<sf::Vertex> oracle (sf::cbegin(va), sf::cend(va));
+        auto const& cva = std::as_const(va);
+        auto const& coracle = std::as_const(oracle);
+
+        iterator_failures += check_iterator_laws(sf::begin(va), sf::end(va), oracle.begin(), rng, steps);
+        iterator_failures += check_iterator_laws(sf::cbegin(cva), sf::cend(cva), coracle.begin(), rng, steps);
+        reverse_failures  += check_iterator_laws(sf::rbegin(va), sf::rend(va), oracle.rbegin(), rng, steps);
+        reverse_failures  += check_iterator_laws(sf::crbegin(cva), sf::crend(cva), coracle.rbegin(), rng, steps);
+    }
+    ENSURE(iterator_failures == 0, "2M random moves of (const) iterators follow the random-access laws");
+    ENSURE(reverse_failures == 0, "2M random moves of reverse iterators follow the random-access laws");
+
+    // standard algorithms give the same results as on std::vector iterators
+    auto const by_x = [](sf::Vertex const& a, sf::Vertex const& b) {
+        return a.position.x < b.position.x;
+    };
+    std::size_t algorithm_failures = 0;
+    auto const check = [&](bool same) { algorithm_failures += same ? 0 : 1; };
+
+    for (std::size_t round=0; round < 2'000; ++round)
+    {
+        // few distinct keys, to exercise equal ranges; y records the original order
+        sf::VertexArray va {sf::Points, rng() % 200};
+        for (std::size_t i=0; i < va.getVertexCount(); ++i)
+            va[i].position = {static_cast<float>(rng() % 16), static_cast<float>(i)};
+        std::vector<sf::Vertex> oracle (sf::cbegin(va), sf::cend(va));
+
+        switch (round % 4) {
+            case 0:
+                std::sort(sf::begin(va), sf::end(va), by_x);
+                std::sort(oracle.begin(), oracle.end(), by_x);
+                break;
+            case 1:
+                std::sort(sf::rbegin(va), sf::rend(va), by_x);
+                std::sort(oracle.rbegin(), oracle.rend(), by_x);
+                break;
+            case 2:
+                std::stable_sort(sf::begin(va), sf::end(va), by_x);
+                std::stable_sort(oracle.begin(), oracle.end(), by_x);
+                for (std::size_t i=0; i < oracle.size(); ++i)
+                    check(va[i].position.y == oracle[i].position.y);
+                break;
+            case 3:
+                if (!oracle.empty()) {
+                    auto const nth = rng() % oracle.size();
+                    std::nth_element(sf::begin(va), sf::begin(va) + nth, sf::end(va), by_x);
+                    std::nth_element(oracle.begin(), oracle.begin() + nth, oracle.end(), by_x);
+                    check(va[nth].position.x == oracle[nth].position.x);
+                    std::sort(sf::begin(va), sf::end(va), by_x);
+                    std::sort(oracle.begin(), oracle.end(), by_x);
+                }
+                break;
+        }
+        check(positions_x(va) == positions_x(oracle));
+
+        sf::Vertex const key {{static_cast<float>(rng() % 17), 0.f}};
+        auto const& cva = std::as_const(va);
+        auto const lower = std::lower_bound(sf::cbegin(cva), sf::cend(cva), key, by_x) - sf::cbegin(cva);
+        auto const upper = std::upper_bound(sf::cbegin(cva), sf::cend(cva), key, by_x) - sf::cbegin(cva);
+        if (round % 4 != 1) {
+            check(lower == std::lower_bound(oracle.begin(), oracle.end(), key, by_x) - oracle.begin());
+            check(upper == std::upper_bound(oracle.begin(), oracle.end(), key, by_x) - oracle.begin());
+        }
+
+        std::reverse(sf::begin(va), sf::end(va));
+        std::reverse(oracle.begin(), oracle.end());
+        check(positions_x(va) == positions_x(oracle));
+    }
+    ENSURE(algorithm_failures == 0, "sort, stable_sort, nth_element, bounds and reverse match std::vector");
+}
+
+
+
+
+void test_view()
+{
+    sf::VertexArray va;
+
+    std::cerr << "--- Array is empty\n";
+    ENSURE(sf::vertices(va).empty(), "view of empty VA is empty");
+    ENSURE(sf::vertices(va).size() == 0, "view of empty VA has size 0");
+
+    for (float x : {0.f, 1.f, 2.f, 3.f, 4.f, 5.f})
+        va.append(sf::Vertex{{x, 0.f}});
+    std::cerr << "\n--- Array has 6 elements now\n";
+
+    auto const view = sf::vertices(va);
+    ENSURE(view.size() == va.getVertexCount(), "view size is VA's size");
+    ENSURE(view.data() == sf::contiguous_begin(va), "view data is the VA's storage");
+    ENSURE(view.begin() == sf::begin(va) && view.end() == sf::end(va), "view spans sf::begin() to sf::end()");
+    ENSURE(view.subview(2, 3).front().position.x == 2.f && view.subview(2, 3).back().position.x == 4.f,
+        "subview spans the requested vertices");
+
+    VertexArray_view<VertexArray_const_iterator> const_view = view;
+    ENSURE(const_view.size() == view.size(), "mutable view converts to const view");
+
+    for (auto& vertex : sf::vertices(va))
+        vertex.position.y = 1.f;
+    ENSURE(va[5].position.y == 1.f, "writes through the view reach the VA");
+
+#if __cplusplus > 201703L
+    auto odd = sf::vertices(std::as_const(va))
+        | std::views::filter([](sf::Vertex const& v) { return static_cast<int>(v.position.x) % 2 == 1; })
+        | std::views::transform([](sf::Vertex const& v) { return v.position.x; });
+    ENSURE(std::ranges::distance(odd) == 3, "filter composes with the view");
+    ENSURE(*std::ranges::begin(odd) == 1.f, "transform composes with the view");
+
+    auto dropped = sf::vertices(va) | std::views::drop(4);
+    ENSURE(&*std::ranges::begin(dropped) == &va[4], "drop yields references into the VA");
+#endif
+}
+
+
+
+
+void test_bulk_operations()
+{
+    // odd size, to cover the scalar tails of the SIMD kernels
+    sf::VertexArray va {sf::Triangles, 37};
+    for (std::size_t i=0; i < va.getVertexCount(); ++i) {
+        auto const f = static_cast<float>(i);
+        va[i] = sf::Vertex{{f, -f}, sf::Color(i * 7 % 256, i * 13 % 256, 255, i * 5 % 256), {2 * f, f}};
+    }
+    auto const original = va;
+
+    auto const same_positions = [](sf::VertexArray const& a, sf::VertexArray const& b) {
+        return std::equal(sf::cbegin(a), sf::cend(a), sf::cbegin(b), [](auto const& u, auto const& v) {
+            return std::abs(u.position.x - v.position.x) < 1e-3f
+                && std::abs(u.position.y - v.position.y) < 1e-3f;
+        });
+    };
+    auto const same_colors_and_tex = [](sf::VertexArray const& a, sf::VertexArray const& b) {
+        return std::equal(sf::cbegin(a), sf::cend(a), sf::cbegin(b), [](auto const& u, auto const& v) {
+            return u.color == v.color && u.texCoords == v.texCoords;
+        });
+    };
+
+    sf::translate(va, {1.5f, 2.f});
+    ENSURE(va[36].position == (sf::Vector2f{37.5f, -34.f}), "translate moves the last vertex");
+    ENSURE(same_colors_and_tex(va, original), "translate leaves colors and texture coordinates");
+
+    sf::Transform transform;
+    transform.rotate(30.f).scale(2.f, 0.5f).translate(-3.f, 4.f);
+    auto expected = va;
+    for (auto& vertex : expected)
+        vertex.position = transform.transformPoint(vertex.position);
+    sf::apply_transform(va, transform);
+    ENSURE(same_positions(va, expected), "apply_transform matches sf::Transform::transformPoint");
+    ENSURE(same_colors_and_tex(va, original), "apply_transform leaves colors and texture coordinates");
+
+    sf::Color const tint_color {200, 100, 50, 128};
+    expected = va;
+    for (auto& vertex : expected)
+        vertex.color = vertex.color * tint_color;
+    sf::tint(va, tint_color);
+    ENSURE(std::equal(sf::cbegin(va), sf::cend(va), sf::cbegin(expected), [](auto const& u, auto const& v) {
+        return u.color == v.color && u.position == v.position;
+    }), "tint matches sf::Color::operator*");
+
+    sf::set_tex_offset(va, {0.5f, -1.f});
+    ENSURE(va[3].texCoords == (sf::Vector2f{6.5f, 2.f}), "set_tex_offset moves texture coordinates");
+
+    sf::VertexArray empty;
+    sf::translate(empty, {1.f, 1.f});
+    sf::apply_transform(empty, transform);
+    sf::tint(empty, tint_color);
+    ENSURE(empty.getVertexCount() == 0, "bulk operations accept an empty VA");
+
+#ifdef SF_VA_SIMD_X86
+    using namespace vertex_array::impl;
+    ENSURE(([&]{
+        auto scalar = original, sse2 = original;
+        transform_scalar(sf::contiguous_begin(scalar), scalar.getVertexCount(), transform);
+        transform_sse2(sf::contiguous_begin(sse2), sse2.getVertexCount(), transform);
+        tint_scalar(sf::contiguous_begin(scalar), scalar.getVertexCount(), tint_color);
+        tint_sse2(sf::contiguous_begin(sse2), sse2.getVertexCount(), tint_color);
+        return same_positions(scalar, sse2) && same_colors_and_tex(scalar, sse2);
+    })(), "SSE2 kernels match the scalar kernels");
+    if (runtime_isa() == Isa::avx2) {
+        ENSURE(([&]{
+            auto scalar = original, avx2 = original;
+            transform_scalar(sf::contiguous_begin(scalar), scalar.getVertexCount(), transform);
+            transform_avx2(sf::contiguous_begin(avx2), avx2.getVertexCount(), transform);
+            tint_scalar(sf::contiguous_begin(scalar), scalar.getVertexCount(), tint_color);
+            tint_avx2(sf::contiguous_begin(avx2), avx2.getVertexCount(), tint_color);
+            add_vec2_scalar<tex_coords_offset>(sf::contiguous_begin(scalar), scalar.getVertexCount(), {1.f, 2.f});
+            add_vec2_avx2<tex_coords_offset>(sf::contiguous_begin(avx2), avx2.getVertexCount(), {1.f, 2.f});
+            return same_positions(scalar, avx2) && same_colors_and_tex(scalar, avx2);
+        })(), "AVX2 kernels match the scalar kernels");
+    }
+#endif
+}
+
+
+
+
+void test_parallel()
+{
+    sf::VertexArray const empty;
+    sf::VertexArray va {sf::Points, 1000};
+
+    ENSURE(sf::split_chunks(empty, 4).empty(), "empty VA splits in no chunk");
+    ENSURE(sf::split_chunks(va, 1).size() == 1, "one chunk spans the whole VA");
+
+    auto const chunks = sf::split_chunks(va, 4);
+    ENSURE(chunks.size() == 4, "VA splits in the requested number of chunks");
+    ENSURE(chunks.front().begin() == sf::begin(va) && chunks.back().end() == sf::end(va),
+        "chunks span the whole VA");
+    ENSURE(std::adjacent_find(chunks.begin(), chunks.end(), [](auto const& a, auto const& b) {
+        return a.end() != b.begin();
+    }) == chunks.end(), "chunks are adjacent");
+    ENSURE(std::all_of(chunks.begin() + 1, chunks.end(), [](auto const& chunk) {
+        return reinterpret_cast<std::uintptr_t>(chunk.data()) % 64 == 0;
+    }), "inner chunk boundaries are cache-line aligned");
+
+    std::vector<std::thread> workers;
+    for (auto const& chunk : chunks) {
+        workers.emplace_back([chunk] {
+            for (auto& vertex : chunk)
+                vertex.position.x += 1.f;
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+    ENSURE(std::all_of(sf::cbegin(va), sf::cend(va), [](auto const& v) { return v.position.x == 1.f; }),
+        "threads visit every vertex once");
+
+#if defined(__cpp_lib_execution) && __cpp_lib_execution >= 201902L
+    std::for_each(std::execution::par_unseq, sf::begin(va), sf::end(va), [](sf::Vertex& vertex) {
+        vertex.position.y += 2.f;
+    });
+    ENSURE(std::all_of(sf::cbegin(va), sf::cend(va), [](auto const& v) { return v.position.y == 2.f; }),
+        "std::for_each with par_unseq visits every vertex once");
+#endif
+}
+
+
+
+
+void test_soa_buffer()
+{
+    sf::VertexArray va {sf::Points, 8};
+    for (std::size_t i=0; i < va.getVertexCount(); ++i)
+        va[i] = sf::Vertex{{static_cast<float>(i), 0.f}, sf::Color::White, {0.f, 1.f}};
+
+    SoAVertexBuffer soa {va};
+    ENSURE(soa.size() == va.getVertexCount(), "SoA buffer has VA's size");
+    ENSURE(!soa.is_dirty(), "fresh SoA buffer is clean");
+    ENSURE(soa.positions()[5] == va[5].position, "positions are gathered");
+    ENSURE(std::distance(soa.cbegin(), soa.cend()) == 8, "SoA iterators span the buffer");
+    ENSURE(static_cast<sf::Vertex>(*(soa.cbegin() + 3)).position.x == 3.f, "const proxy converts to sf::Vertex");
+
+    float sum = 0.f;
+    for (auto const& vertex : std::as_const(soa))
+        sum += vertex.position.x;
+    ENSURE(sum == 28.f && !soa.is_dirty(), "const iteration reads without marking dirty");
+
+    auto* positions = soa.edit_positions(2, 4);
+    positions[2].y = 5.f;
+    positions[3].y = 6.f;
+    va[1].color = sf::Color::Red;
+    soa.scatter(va);
+    ENSURE(va[2].position.y == 5.f && va[3].position.y == 6.f, "scatter writes back dirty positions");
+    ENSURE(va[1].color == sf::Color::Red, "scatter leaves fields that were not written");
+    ENSURE(!soa.is_dirty(), "scatter clears the dirty ranges");
+
+    sum = 0.f;
+    for (auto vertex : soa)
+        sum += vertex.position.get().x + static_cast<sf::Vertex>(vertex).texCoords.y;
+    ENSURE(sum == 36.f && !soa.is_dirty(), "reads through mutable proxies mark nothing");
+
+    for (auto vertex : soa)
+        vertex.color = sf::Color::Black;
+    ENSURE(soa.is_dirty(), "field assignment marks the field dirty");
+    *(soa.begin() + 7) = sf::Vertex{{70.f, 70.f}};
+    soa[6].position.edit().x += 1.f;
+    soa[5].texCoords += sf::Vector2f{1.f, 0.f};
+    va[0].position.y = -1.f;
+    soa.scatter(va);
+    ENSURE(va[1].color == sf::Color::Black, "mutable iteration marks vertices dirty");
+    ENSURE(va[7].position.x == 70.f, "vertex assignment through the proxy is scattered");
+    ENSURE(va[6].position.x == 7.f && va[5].texCoords.x == 1.f, "edit() and compound assignment are scattered");
+    ENSURE(va[0].position.y == -1.f, "positions outside the written range are not scattered");
+
+    soa.edit_colors(5, 40)[7] = sf::Color::Green;
+    soa.edit_tex_coords(20, 30);
+    soa.scatter(va);
+    ENSURE(va[7].color == sf::Color::Green && va.getVertexCount() == 8 && !soa.is_dirty(),
+        "edits past the end are clamped to the buffer");
+
+    // mutating algorithms go through the proxies
+    SoAVertexBuffer sorted {va};
+    std::reverse(sorted.begin(), sorted.end());
+    ENSURE(sorted.positions()[0] == va[7].position && sorted.colors()[7] == va[0].color && sorted.is_dirty(),
+        "std::reverse swaps whole vertices and marks them");
+    std::sort(sorted.begin(), sorted.end(), [](sf::Vertex const& a, sf::Vertex const& b) {
+        return a.position.x < b.position.x;
+    });
+    sorted.scatter(va);
+    ENSURE(std::is_sorted(sf::cbegin(va), sf::cend(va), [](sf::Vertex const& a, sf::Vertex const& b) {
+        return a.position.x < b.position.x;
+    }) && va[7].position.x == 70.f && va[7].texCoords.y == 0.f && va[6].texCoords.y == 1.f,
+        "std::sort through SoA iterators moves whole vertices");
+
+    sf::VertexArray other;
+    soa.scatter(other);
+    ENSURE(other.getVertexCount() == soa.size() && other[4].position.x == 4.f,
+        "scatter to an array of another size copies everything");
+}
+
+
+
+
+void test_dirty_tracking()
+{
+    struct Mock_buffer
+    {
+        struct Update { sf::Vertex const* vertices; std::size_t count; unsigned offset; };
+        std::vector<Update> updates;
+
+        bool update(sf::Vertex const* vertices, std::size_t count, unsigned offset)
+        {
+            updates.push_back({vertices, count, offset});
+            return true;
+        }
+    };
+
+    VertexArray_dirty_ranges dirty;
+    dirty.add(10, 12);
+    dirty.add(4, 6);
+    dirty.add(6, 8);
+    dirty.add(11, 15);
+    dirty.add(20);
+    ENSURE(dirty.ranges().size() == 3, "adjacent and overlapping ranges are coalesced");
+    ENSURE(dirty.ranges().at(4) == 8 && dirty.ranges().at(10) == 15 && dirty.ranges().at(20) == 21,
+        "coalesced ranges have the expected bounds");
+    dirty.add(0, 30);
+    ENSURE(dirty.ranges().size() == 1 && dirty.vertex_count() == 30, "a covering range swallows the others");
+    dirty.clear();
+
+    // ranges grown in place match a per-index reference after every add
+    {
+        std::mt19937 rng {8};
+        std::vector<bool> expected (200, false);
+        VertexArray_dirty_ranges random;
+        bool exact = true;
+        for (int i=0; i < 520; ++i) {
+            std::size_t const lo = rng() % 200;
+            auto const hi = std::min<std::size_t>(lo + rng() % (i % 7 == 0 ? 40 : 6), 200);
+            random.add(lo, hi);
+            for (auto k = lo; k < hi; ++k)
+                expected[k] = true;
+
+            std::vector<bool> recorded (200, false);
+            std::size_t previous_last = 0;
+            bool first_range = true;
+            for (auto const& [first, last] : random.ranges()) {
+                exact = exact && first < last && (first_range || first > previous_last);
+                first_range = false;
+                previous_last = last;
+                for (auto k = first; k < last; ++k)
+                    recorded[k] = true;
+            }
+            exact = exact && recorded == expected;
+
+            if (i % 50 == 49) {
+                std::fill(expected.begin(), expected.end(), false);
+                random.clear();
+            }
+        }
+        ENSURE(exact, "random ranges stay disjoint, non-adjacent and exact");
+
+        VertexArray_dirty_ranges sequential;
+        for (std::size_t k=50; k > 40; --k)
+            sequential.add(k);
+        for (std::size_t k=51; k < 60; ++k)
+            sequential.add(k);
+        ENSURE(sequential.ranges().size() == 1 && sequential.ranges().at(41) == 60,
+            "sequential writes in both directions grow one range");
+    }
+
+    sf::VertexArray va {sf::Points, 16};
+    auto const first = sf::tracking_begin(va, dirty);
+    auto const last  = sf::tracking_end(va, dirty);
+
+    float sum = 0.f;
+    for (auto it = first; it != last; ++it)
+        sum += it->position.x;
+    ENSURE(dirty.empty(), "reading through the tracking iterator records nothing");
+
+    first[3] = sf::Vertex{{3.f, 3.f}};
+    (*(first + 4)).edit().color = sf::Color::Red;
+    std::fill(first + 9, first + 12, sf::Vertex{{9.f, 9.f}});
+    ENSURE(va[4].color == sf::Color::Red && va[11].position.x == 9.f, "writes reach the VA");
+
+    Mock_buffer buffer;
+    ENSURE(sf::upload(buffer, va, dirty), "upload succeeds");
+    ENSURE(buffer.updates.size() == 2, "one update per coalesced range");
+    ENSURE(buffer.updates[0].offset == 3 && buffer.updates[0].count == 2 && buffer.updates[0].vertices == &va[3],
+        "first update covers vertices 3 and 4");
+    ENSURE(buffer.updates[1].offset == 9 && buffer.updates[1].count == 3, "second update covers vertices 9 to 11");
+    ENSURE(dirty.empty(), "upload clears the dirty ranges");
+
+    dirty.add(14, 20);
+    dirty.add(30, 40);
+    buffer.updates.clear();
+    ENSURE(sf::upload(buffer, va, dirty) && dirty.empty(), "ranges past a shrunk array are clamped, not failed");
+    ENSURE(buffer.updates.size() == 1 && buffer.updates[0].offset == 14 && buffer.updates[0].count == 2,
+        "the part still in the array is uploaded");
+
+    // mutating algorithms through the proxies
+    sf::VertexArray order {sf::Points, 12};
+    for (std::size_t i=0; i < order.getVertexCount(); ++i)
+        order[i].position.x = static_cast<float>(i);
+    auto const tracked = sf::tracking_begin(order, dirty);
+    std::reverse(tracked + 2, tracked + 6);
+    ENSURE(order[2].position.x == 5.f && order[5].position.x == 2.f, "std::reverse through tracking iterators");
+    ENSURE(dirty.ranges().size() == 1 && dirty.ranges().begin()->first == 2 && dirty.ranges().begin()->second == 6,
+        "swapped vertices are recorded");
+
+    dirty.clear();
+    *(tracked + 8) = *(tracked + 11);
+    ENSURE(order[8].position.x == 11.f && dirty.vertex_count() == 1 && dirty.ranges().count(8) == 1,
+        "proxy to proxy assignment records the target only");
+
+    dirty.clear();
+    std::sort(tracked, sf::tracking_end(order, dirty), [](sf::Vertex const& a, sf::Vertex const& b) {
+        return a.position.x < b.position.x;
+    });
+    ENSURE(std::is_sorted(sf::cbegin(order), sf::cend(order), [](sf::Vertex const& a, sf::Vertex const& b) {
+        return a.position.x < b.position.x;
+    }), "std::sort through tracking iterators");
+    ENSURE(!dirty.empty() && dirty.ranges().rbegin()->second <= 12, "sorting records its writes");
+}
+
+
+
+
+void test_primitive_iterator()
+{
+#if __cplusplus > 201703L
+    sf::VertexArray va {sf::Quads, 10};
+    for (std::size_t i=0; i < va.getVertexCount(); ++i)
+        va[i].position.x = static_cast<float>(i);
+
+    auto const quads = sf::primitives<sf::Quads>(va);
+    ENSURE(quads.size() == 2, "trailing incomplete quad is ignored");
+    ENSURE(decltype(*quads.begin())::extent == 4, "quad spans have a static extent of 4");
+    ENSURE(quads[1][0].position.x == 4.f && quads[1][3].position.x == 7.f, "second quad spans vertices 4 to 7");
+    ENSURE((*quads.rbegin())[0].position.x == 4.f, "reverse iteration starts at the last complete quad");
+    ENSURE(std::distance(quads.rbegin(), quads.rend()) == 2, "reverse iteration visits every quad");
+
+    for (auto quad : quads) {
+        quad[0].texCoords = {0.f, 0.f};
+        quad[1].texCoords = {1.f, 0.f};
+        quad[2].texCoords = {1.f, 1.f};
+        quad[3].texCoords = {0.f, 1.f};
+    }
+    ENSURE(va[6].texCoords == (sf::Vector2f{1.f, 1.f}), "writes through quad spans reach the VA");
+    ENSURE(va[9].texCoords == (sf::Vector2f{0.f, 0.f}), "vertices past the last quad are untouched");
+
+    auto const triangles = sf::primitives<sf::Triangles>(std::as_const(va));
+    ENSURE(triangles.size() == 3, "10 vertices hold 3 triangles");
+    ENSURE(std::is_const_v<decltype(triangles)::iterator::value_type::element_type>,
+        "const array yields spans of const vertices");
+
+    auto const strip = sf::primitives<sf::TriangleStrip>(va);
+    ENSURE(strip.size() == 8, "10 vertices hold 8 strip triangles");
+    ENSURE(strip[7][2].position.x == 9.f, "last strip triangle ends on the last vertex");
+    sf::VertexArray const empty;
+    ENSURE(sf::primitives<sf::Lines>(empty).empty(), "empty VA has no primitive");
+#endif
+}
+
+
+
+
+void test_builder()
+{
+    VertexArrayBuilder builder {64};
+    ENSURE(builder.empty() && builder.capacity() >= 64, "builder reserves its initial capacity");
+
+    builder.append(sf::Vertex{{0.f, 0.f}});
+    auto* quad = builder.grow(4);
+    for (int i=0; i < 4; ++i)
+        quad[i].position = {static_cast<float>(i + 1), 0.f};
+
+    sf::VertexArray source {sf::Points, 3};
+    std::copy(sf::cbegin(source), sf::cend(source), builder.back_inserter());
+    ENSURE(builder.size() == 8, "builder holds every appended vertex");
+
+    sf::VertexArray va {sf::Quads};
+    builder.build(va);
+    ENSURE(va.getVertexCount() == 8 && va.getPrimitiveType() == sf::Quads, "build sizes the VA and keeps its type");
+    ENSURE(va[4].position.x == 4.f, "build copies the staged vertices");
+
+    auto const capacity = builder.capacity();
+    builder.clear();
+    ENSURE(builder.empty() && builder.capacity() == capacity, "clear keeps the arena");
+
+    builder.append(source);
+    auto const built = builder.build(sf::Triangles);
+    ENSURE(built.getVertexCount() == 3 && built.getPrimitiveType() == sf::Triangles, "build returns a new VA");
+}
+
+
+
+
+void test_culler()
+{
+    // a 10x10 grid of unit quads, 10 units apart
+    sf::VertexArray tiles {sf::Quads};
+    for (int y=0; y < 10; ++y)
+    for (int x=0; x < 10; ++x) {
+        sf::Vector2f const origin {x * 10.f, y * 10.f};
+        tiles.append(sf::Vertex{origin});
+        tiles.append(sf::Vertex{origin + sf::Vector2f{1.f, 0.f}});
+        tiles.append(sf::Vertex{origin + sf::Vector2f{1.f, 1.f}});
+        tiles.append(sf::Vertex{origin + sf::Vector2f{0.f, 1.f}});
+    }
+    sf::VertexArray strip {sf::TriangleStrip, 3};
+    strip[0].position = {500.f, 500.f};
+    strip[1].position = {510.f, 500.f};
+    strip[2].position = {500.f, 510.f};
+
+    VertexCuller culler {16.f};
+    auto const tiles_id = culler.add(tiles);
+    auto const strip_id = culler.add(strip);
+    ENSURE(culler.primitive_count(tiles_id) == 100, "every quad is indexed");
+    ENSURE(culler.primitive_count(strip_id) == 1, "a strip is indexed as a whole");
+
+    sf::VertexArray visible {sf::Quads};
+    culler.cull({-1.f, -1.f, 22.f, 12.f}, sf::back_inserter(visible));
+    ENSURE(visible.getVertexCount() == 3 * 2 * 4, "cull keeps the 6 quads in view");
+    ENSURE(visible[4].position.x == 10.f && visible[4].position.y == 0.f, "visible quads keep array order");
+
+    visible.clear();
+    culler.cull({505.f, 505.f, 1.f, 1.f}, sf::back_inserter(visible));
+    ENSURE(visible.getVertexCount() == 3, "a visible strip is written whole");
+
+    // move the first quad far away and re-index it only
+    for (std::size_t i=0; i < 4; ++i)
+        tiles[i].position += sf::Vector2f{1000.f, 1000.f};
+    culler.update(tiles_id, 0, 1);
+
+    visible.clear();
+    culler.cull({-1.f, -1.f, 5.f, 5.f}, sf::back_inserter(visible));
+    ENSURE(visible.getVertexCount() == 0, "moved quad left its old cell");
+    culler.cull({999.f, 999.f, 5.f, 5.f}, sf::back_inserter(visible));
+    ENSURE(visible.getVertexCount() == 4, "moved quad is found in its new cell");
+
+    culler.update(tiles_id, 150, 10);
+    culler.update(tiles_id, 99, 500);
+    visible.clear();
+    culler.cull({0.f, 0.f, 100.f, 100.f}, sf::back_inserter(visible));
+    ENSURE(visible.getVertexCount() == 99 * 4, "update clamps out-of-range and reversed ranges");
+
+    culler.remove(strip_id);
+    visible.clear();
+    culler.cull({0.f, 0.f, 600.f, 600.f}, sf::back_inserter(visible));
+    ENSURE(visible.getVertexCount() == 99 * 4, "removed source is no longer culled");
+
+    // non-finite and far coordinates
+    sf::VertexArray odd {sf::Quads, 12};
+    for (std::size_t i=0; i < 12; ++i)
+        odd[i].position = {static_cast<float>(i % 4 == 1 || i % 4 == 2), static_cast<float>(i % 4 >= 2)};
+    odd[1].position.x = std::numeric_limits<float>::quiet_NaN();   // quad 0 has a NaN corner
+    odd[6].position = {1e30f, 1e30f};                               // quad 1 reaches 1e30
+    for (std::size_t i=8; i < 12; ++i)
+        odd[i].position += sf::Vector2f{1e30f, -1e30f};            // quad 2 sits at 1e30
+    VertexCuller far_culler {16.f};
+    auto const odd_id = far_culler.add(odd);
+
+    sf::VertexArray seen {sf::Quads};
+    far_culler.cull({-1.f, -1.f, 3.f, 3.f}, sf::back_inserter(seen));
+    ENSURE(seen.getVertexCount() == 4 && seen[2].position.x == 1e30f, "a NaN primitive is skipped, a huge one is found");
+    seen.clear();
+    far_culler.cull({1e30f, -1e30f, 1.f, 1.f}, sf::back_inserter(seen));
+    ENSURE(seen.getVertexCount() == 4 && seen[0].position.x == 1e30f, "a primitive at 1e30 is found");
+    seen.clear();
+    far_culler.cull({-1e30f, -2e30f, 4e30f, 4e30f}, sf::back_inserter(seen));
+    ENSURE(seen.getVertexCount() == 8, "a view covering everything but NaN");
+
+    odd[6].position = {1.f, 1.f};
+    far_culler.update(odd_id, 1, 2);
+    seen.clear();
+    far_culler.cull({0.5f, 0.5f, 1.f, 1.f}, sf::back_inserter(seen));
+    ENSURE(seen.getVertexCount() == 4, "a huge primitive shrunk back into the grid");
+    seen.clear();
+    far_culler.cull({100.f, 100.f, 1.f, 1.f}, sf::back_inserter(seen));
+    ENSURE(seen.getVertexCount() == 0, "a shrunk primitive left the large list");
+}
+
+
+
+
+void test_reduce()
+{
+    // odd count, so that every kernel runs its scalar tail
+    sf::VertexArray va {sf::Points, 1001};
+    for (std::size_t i=0; i < va.getVertexCount(); ++i) {
+        auto const f = static_cast<float>(i);
+        va[i].position = {std::sin(f) * 100.f + 3.f, std::cos(f * 0.5f) * 50.f - 7.f};
+        va[i].color = sf::Color(static_cast<sf::Uint8>(i % 4), 0, 255, 255);
+    }
+    va[997].position = {-500.f, 900.f};
+
+    auto const expected = va.getBounds();
+    auto const b = sf::bounds(va);
+    ENSURE(b.left == expected.left && b.top == expected.top, "bounds origin matches getBounds()");
+    ENSURE(b.width == expected.width && b.height == expected.height, "bounds size matches getBounds()");
+    ENSURE(sf::bounds(sf::VertexArray{}).width == 0.f, "bounds of an empty array is empty");
+
+    sf::VertexArray square {sf::Quads, 4};
+    square[1].position = {2.f, 0.f};
+    square[2].position = {2.f, 4.f};
+    square[3].position = {0.f, 4.f};
+    auto const center = sf::centroid(square);
+    ENSURE(center.x == 1.f && center.y == 2.f, "centroid is the mean position");
+
+    auto const histogram = sf::color_histogram(va);
+    ENSURE(histogram.r[0] == 251 && histogram.r[3] == 250, "histogram counts red values");
+    ENSURE(histogram.b[255] == 1001 && histogram.g[0] == 1001, "histogram counts every vertex");
+
+    auto const max_x = sf::reduce(va, -1e9f,
+        [](float a, float b) { return std::max(a, b); },
+        [](sf::Vertex const& v) { return v.position.x; }
+    );
+    auto const rightmost = std::max_element(sf::cbegin(va), sf::cend(va),
+        [](sf::Vertex const& a, sf::Vertex const& b) { return a.position.x < b.position.x; }
+    );
+    ENSURE(max_x == rightmost->position.x, "reduce with a projection");
+
+    auto const count = sf::reduce(va, std::size_t{0},
+        [](std::size_t a, std::size_t b) { return a + b; },
+        [](sf::Vertex const&) { return std::size_t{1}; }
+    );
+    ENSURE(count == va.getVertexCount(), "reduce visits every vertex once");
+
+    using Span = std::pair<float, float>;
+    auto const span = sf::reduce(va, Span{1e9f, -1e9f},
+        [](Span a, Span b) { return Span{std::min(a.first, b.first), std::max(a.second, b.second)}; },
+        [](sf::Vertex const& v) { return Span{v.position.x, v.position.x}; }
+    );
+    ENSURE(span.first == expected.left && span.second == rightmost->position.x,
+        "reduce combines projected values with op");
+
+    // threaded path, forced regardless of the hardware
+    {
+        using namespace vertex_array::impl;
+        sf::VertexArray large {sf::Points, 100'000};
+        for (std::size_t i=0; i < large.getVertexCount(); ++i)
+            large[i].position = {static_cast<float>(i), -static_cast<float>(i)};
+
+        auto const sum = parallel_reduce(sf::contiguous_begin(large), large.getVertexCount(), 4,
+            std::size_t{0},
+            [](sf::Vertex const*, std::size_t size) { return size; },
+            [](std::size_t a, std::size_t b) { return a + b; }
+        );
+        ENSURE(sum == large.getVertexCount(), "threaded chunks cover the range");
+
+        auto const threaded = parallel_reduce(sf::contiguous_begin(large), large.getVertexCount(), 4,
+            Position_bounds{},
+            [](sf::Vertex const* first, std::size_t size) { return vertex_array::impl::bounds(first, size); },
+            merge_bounds
+        );
+        ENSURE(threaded.right == 99'999.f && threaded.top == -99'999.f, "threaded bounds");
+    }
+
+    // cached results follow the writes recorded by the tracking iterators
+    VertexArray_dirty_ranges dirty;
+    VertexArray_reduce_cache cache {va, dirty};
+    auto const cached = cache.bounds();
+    ENSURE(cached.left == expected.left, "cache computes on first query");
+
+    ENSURE(cache.bounds().left == expected.left, "repeated query returns the cached bounds");
+
+    *sf::tracking_begin(va, dirty) = sf::Vertex{{-1000.f, va[0].position.y}, va[0].color};
+    ENSURE(cache.bounds().left == -1000.f, "tracked write invalidates the cache");
+
+    va.append(sf::Vertex{{0.f, 5000.f}});
+    ENSURE(cache.bounds().top + cache.bounds().height == 5000.f, "resize invalidates the cache");
+    ENSURE(cache.color_histogram().a[255] == 1002, "cached histogram");
+
+    va[1].position = {-2000.f, 0.f};    // untracked write, needs invalidate()
+    cache.invalidate();
+    ENSURE(cache.bounds().left == -2000.f, "invalidate() forces a new reduction");
+
+    sf::apply_transform(va, sf::Transform{}.translate(1.f, 0.f));
+    cache.invalidate();
+    ENSURE(cache.bounds().left == -1999.f, "invalidate() after a transform kernel");
+}
+
+
+
+
+void test_file()
+{
+    sf::VertexArray va {sf::Triangles, 999};
+    for (std::size_t i=0; i < va.getVertexCount(); ++i) {
+        auto const f = static_cast<float>(i);
+        va[i].position = {f * 0.5f - 100.f, 300.f - f};
+        va[i].color = sf::Color(static_cast<sf::Uint8>(i), 10, 20, 30);
+        va[i].texCoords = {f, 64.f};
+    }
+
+    auto const dir = std::filesystem::temp_directory_path();
+    auto const raw_path = (dir / "sf_va_test_raw.sfva").string();
+    auto const quantized_path = (dir / "sf_va_test_quantized.sfva").string();
+
+    ENSURE(sf::save_vertices(va, raw_path), "raw file is written");
+    ENSURE(sf::save_vertices(va, quantized_path, VertexArrayFile_format::quantized), "quantized file is written");
+
+    VertexArrayFile file;
+    ENSURE(!file.open((dir / "sf_va_test_missing.sfva").string()), "missing file fails to open");
+    ENSURE(file.open(raw_path), "raw file opens");
+    ENSURE(file.size() == 999 && file.primitive_type() == sf::Triangles, "header is read back");
+    ENSURE(file.data() != nullptr, "raw records are mapped in place");
+    ENSURE(std::equal(file.data(), file.data() + file.size(), sf::cbegin(va),
+        [](sf::Vertex const& a, sf::Vertex const& b) {
+            return a.position == b.position && a.color == b.color && a.texCoords == b.texCoords;
+        }), "raw records match the array");
+    ENSURE(std::distance(file.begin(), file.end()) == 999, "file iterators span every vertex");
+    ENSURE((*(file.begin() + 5)).position == va[5].position, "file iterators read records");
+    ENSURE((std::is_same_v<std::iterator_traits<VertexArrayFile_iterator>::iterator_category, std::input_iterator_tag>),
+        "file iterators return by value: input category");
+#if __cplusplus > 201703L
+    ENSURE(std::random_access_iterator<VertexArrayFile_iterator>, "file iterators model random access");
+#endif
+
+    // streaming, chunk by chunk, after existing vertices
+    sf::VertexArray streamed {sf::Triangles, 1};
+    std::size_t chunks = 0;
+    for (std::size_t first=0; file.read(streamed, first, 256) != 0; first += 256)
+        ++chunks;
+    ENSURE(chunks == 4 && streamed.getVertexCount() == 1000, "chunks are appended");
+    ENSURE(streamed[1].position == va[0].position && streamed[999].position == va[998].position,
+        "chunks land after the existing vertices");
+
+    VertexArrayFile quantized;
+    ENSURE(quantized.open(quantized_path), "quantized file opens");
+    ENSURE(quantized.data() == nullptr, "quantized records are not mapped as vertices");
+
+    sf::VertexArray loaded;
+    quantized.load(loaded);
+    ENSURE(loaded.getVertexCount() == 999 && loaded.getPrimitiveType() == sf::Triangles, "load replaces the array");
+
+    auto max_error = 0.f;
+    for (std::size_t i=0; i < va.getVertexCount(); ++i) {
+        max_error = std::max(max_error, std::abs(loaded[i].position.x - va[i].position.x));
+        max_error = std::max(max_error, std::abs(loaded[i].position.y - va[i].position.y));
+        max_error = std::max(max_error, std::abs(loaded[i].texCoords.x - va[i].texCoords.x));
+    }
+    ENSURE(max_error < 0.01f, "quantization error is within a 16-bit step");
+    ENSURE(loaded[7].color == va[7].color && loaded[7].texCoords.y == 64.f, "colors and flat extents are exact");
+
+    std::filesystem::resize_file(raw_path, 100);
+    ENSURE(!file.open(raw_path), "truncated file fails to open");
+    ENSURE(!file.is_open(), "failed open leaves the file closed");
+
+    std::filesystem::remove(raw_path);
+    std::filesystem::remove(quantized_path);
+}
+
+
+
+
+void test_compressed()
+{
+    // odd count, so that the SIMD decode runs its scalar tail
+    sf::VertexArray va {sf::Quads, 1003};
+    for (std::size_t i=0; i < va.getVertexCount(); ++i) {
+        auto const f = static_cast<float>(i);
+        va[i].position = {f * 1.5f - 200.f, std::sin(f) * 300.f};
+        va[i].color = sf::Color(static_cast<sf::Uint8>(i % 7 * 30), 40, 50, 255);
+        va[i].texCoords = {static_cast<float>(i % 4) * 32.f, 16.f};
+    }
+
+    CompressedVertexArray compressed;
+    ENSURE(compressed.encode(va), "array with small palettes is encoded");
+    ENSURE(compressed.getVertexCount() == 1003 && compressed.getPrimitiveType() == sf::Quads, "size and type are kept");
+    ENSURE(compressed.memory_size() < 1003 * 8 + 64, "8 bytes per vertex plus the palettes");
+
+    sf::VertexArray decoded;
+    compressed.decode(decoded);
+
+    auto exact = true;
+    auto max_error = 0.f;
+    for (std::size_t i=0; i < va.getVertexCount(); ++i) {
+        exact = exact && decoded[i].color == va[i].color && decoded[i].texCoords == va[i].texCoords;
+        max_error = std::max(max_error, std::abs(decoded[i].position.x - va[i].position.x));
+        max_error = std::max(max_error, std::abs(decoded[i].position.y - va[i].position.y));
+    }
+    ENSURE(exact, "colors and texture coordinates round-trip exactly");
+    ENSURE(max_error <= 1503.f / 65535.f, "positions round-trip within a 16-bit step");
+    ENSURE(decoded.getPrimitiveType() == sf::Quads, "decode restores the primitive type");
+
+    ENSURE(std::distance(compressed.begin(), compressed.end()) == 1003, "iterators span every vertex");
+    ENSURE(std::equal(compressed.begin(), compressed.end(), sf::cbegin(decoded),
+        [](sf::Vertex const& a, sf::Vertex const& b) {
+            return a.position == b.position && a.color == b.color && a.texCoords == b.texCoords;
+        }), "sequential iteration matches the decoded array");
+
+    auto it = compressed.end();
+    --it;
+    ENSURE((*it).position == decoded[1002].position, "last vertex of a partial batch");
+    ENSURE(it[-500].position == decoded[502].position, "subscript decodes another batch");
+    ENSURE((std::is_same_v<std::iterator_traits<CompressedVertexArray_iterator>::iterator_category, std::input_iterator_tag>),
+        "compressed iterators return by value: input category");
+#if __cplusplus > 201703L
+    ENSURE(std::random_access_iterator<CompressedVertexArray_iterator>, "compressed iterators model random access");
+#endif
+    ENSURE(compressed[9].color == va[9].color, "single vertex access");
+
+    CompressedVertexArray cleared;
+    cleared.encode(va);
+    cleared.clear();
+    ENSURE(cleared.empty() && cleared.getPrimitiveType() == sf::Points, "clear resets the primitive type");
+
+    sf::VertexArray noisy {sf::Points, 70'000};
+    for (std::size_t i=0; i < noisy.getVertexCount(); ++i)
+        noisy[i].texCoords = {static_cast<float>(i), 0.f};
+    ENSURE(!compressed.encode(noisy), "too many distinct texture coordinates");
+    ENSURE(compressed.empty(), "failed encode leaves the array empty");
+}
+
+
+
+
+void test_sort_primitives()
+{
+    std::mt19937 rng {7};
+
+    // quad q holds 4 vertices at y == q, its key in the color
+    auto const make_quads = [&](std::size_t quads, std::size_t extra_vertices) {
+        sf::VertexArray va {sf::Quads, quads * 4 + extra_vertices};
+        for (std::size_t q=0; q < quads; ++q) {
+            auto const key = static_cast<sf::Uint8>(rng() % 50);
+            for (std::size_t v=0; v < 4; ++v) {
+                va[q*4 + v].position = {static_cast<float>(v), static_cast<float>(q)};
+                va[q*4 + v].color.r = key;
+            }
+        }
+        return va;
+    };
+    auto const key_of = [](sf::Vertex const* quad) { return static_cast<std::uint32_t>(quad[0].color.r); };
+
+    // expected order of the quads: stable by key
+    auto const expected_order = [&](sf::VertexArray const& va) {
+        std::vector<std::size_t> order (va.getVertexCount() / 4);
+        for (std::size_t q=0; q < order.size(); ++q)
+            order[q] = q;
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+            return va[a*4].color.r < va[b*4].color.r;
+        });
+        return order;
+    };
+    auto const sorted_as = [](sf::VertexArray const& va, std::vector<std::size_t> const& order) {
+        for (std::size_t q=0; q < order.size(); ++q)
+            for (std::size_t v=0; v < 4; ++v)
+                if (va[q*4 + v].position != sf::Vector2f{static_cast<float>(v), static_cast<float>(order[q])})
+                    return false;
+        return true;
+    };
+
+    auto va = make_quads(1000, 3);
+    auto const order = expected_order(va);
+    ENSURE(sf::sort_primitives(va, key_of), "quads are sortable");
+    ENSURE(sorted_as(va, order), "quads move as units, in stable key order");
+    ENSURE(va[4000].position == sf::Vector2f{} && va.getVertexCount() == 4003, "trailing incomplete quad stays at the end");
+
+    auto large = make_quads(100'000, 0);
+    auto const large_order = expected_order(large);
+    VertexArray_primitive_sorter<std::uint64_t> sorter;
+    ENSURE(sorter.sort(large, [](sf::Vertex const* quad) {
+        return std::uint64_t{quad[0].color.r} << 40;
+    }), "64-bit keys");
+    ENSURE(sorted_as(large, large_order), "threaded keys and high key bytes sort like a stable sort");
+
+    sf::VertexArray triangles {sf::Triangles, 9};
+    for (std::size_t i=0; i < 9; ++i)
+        triangles[i].position.x = static_cast<float>(8 - i);
+    sf::sort_primitives(triangles, [](sf::Vertex const* t) { return static_cast<unsigned>(t[0].position.x); });
+    ENSURE(triangles[0].position.x == 2.f && triangles[2].position.x == 0.f && triangles[8].position.x == 6.f,
+        "triangles move as units of 3 vertices");
+
+    sf::VertexArray strip {sf::TriangleStrip, 6};
+    ENSURE(!sf::sort_primitives(strip, key_of), "strips cannot be reordered");
+}
+
+
+
+void test_merge()
+{
+    // piece p holds p+1 vertices at x == p
+    std::vector<sf::VertexArray> pieces;
+    std::vector<sf::Transform> transforms;
+    for (std::size_t p=0; p < 5; ++p) {
+        pieces.emplace_back(sf::Triangles, p + 1);
+        for (std::size_t i=0; i <= p; ++i)
+            pieces.back()[i].position = {static_cast<float>(p), static_cast<float>(i)};
+        transforms.push_back(sf::Transform{}.translate(0.f, 100.f * static_cast<float>(p)));
+    }
+
+    sf::VertexArray batch {sf::Points, 3};
+    auto const table = sf::merge(pieces.begin(), pieces.end(), transforms.begin(), batch);
+    ENSURE(table.size() == 5 && table.vertex_count() == 15 && batch.getVertexCount() == 15, "one output for all pieces");
+    ENSURE(batch.getPrimitiveType() == sf::Triangles, "output takes the primitive type of the pieces");
+    ENSURE(table.offset(3) == 6 && table.count(3) == 4, "offset table");
+    ENSURE(batch[7].position == sf::Vector2f(3.f, 301.f), "pieces are copied and transformed");
+    ENSURE(table.piece(batch, 4).front().position == sf::Vector2f(4.f, 400.f), "piece view");
+
+    pieces[2][1].position = {-1.f, -1.f};
+    ENSURE(table.patch(batch, 2, pieces[2]), "patch a piece");
+    ENSURE(batch[4].position == sf::Vector2f(-1.f, -1.f) && batch[6].position == sf::Vector2f(3.f, 300.f),
+        "patching leaves the other pieces alone");
+    ENSURE(!table.patch(batch, 1, pieces[2]), "patch needs the vertex count of the piece");
+
+    auto const plain = sf::merge(pieces.begin(), pieces.end(), batch);
+    ENSURE(plain.size() == 5 && batch[14].position == sf::Vector2f(4.f, 4.f), "merge without transforms");
+
+    std::vector<sf::VertexArray> none;
+    ENSURE(sf::merge(none.begin(), none.end(), batch).empty() && batch.getVertexCount() == 0, "merge nothing");
+
+    // large pieces, merged on several threads
+    std::vector<sf::VertexArray> large (3, sf::VertexArray{sf::Quads, 50'001});
+    for (std::size_t p=0; p < large.size(); ++p)
+        for (std::size_t i=0; i < large[p].getVertexCount(); ++i)
+            large[p][i].position = {static_cast<float>(p), static_cast<float>(i)};
+    std::vector<sf::Transform> shifts (3, sf::Transform{}.translate(1.f, 0.f));
+
+    auto const large_table = sf::merge(large.begin(), large.end(), shifts.begin(), batch);
+    bool same = true;
+    for (std::size_t p=0; p < large.size(); ++p)
+        for (std::size_t i=0; i < large[p].getVertexCount(); ++i)
+            same = same && batch[large_table.offset(p) + i].position
+                == sf::Vector2f(static_cast<float>(p) + 1.f, static_cast<float>(i));
+    ENSURE(same, "threaded merge");
+}
+
+
+
+void test_zip()
+{
+    std::mt19937 rng {3};
+    std::uniform_real_distribution<float> dist {-500.f, 500.f};
+    auto const make_keyframe = [&](std::size_t count) {
+        sf::VertexArray va {sf::Triangles, count};
+        for (std::size_t i=0; i < count; ++i) {
+            va[i].position = {dist(rng), dist(rng)};
+            va[i].color = sf::Color(rng() % 256, rng() % 256, rng() % 256, rng() % 256);
+        }
+        return va;
+    };
+
+    auto const a = make_keyframe(1003);
+    auto const b = make_keyframe(1003);
+    sf::VertexArray out {sf::Triangles, 1010};
+
+    auto zipped = sf::zip(a, b, out);
+    ENSURE(zipped.size() == 1003, "zip stops at the shortest array");
+    ENSURE(&std::get<2>(zipped[5]) == &out[5] && &std::get<0>(*zipped.begin()) == &a[0], "tuple of references");
+    ENSURE(zipped.end() - zipped.begin() == 1003 && zipped.begin() + 1003 == zipped.end(), "random-access moves");
+
+    float const t = 0.3f;
+    for (auto [va, vb, vo] : zipped)
+        vo.position = va.position + (vb.position - va.position) * t;
+    bool blended = true;
+    for (std::size_t i=0; i < 1003; ++i)
+        blended = blended && out[i].position == a[i].position + (b[i].position - a[i].position) * t;
+    ENSURE(blended, "structured bindings write through the references");
+
+    std::size_t steps = 0;
+    for (auto it = zipped.end(); it != zipped.begin(); --it)
+        ++steps;
+    ENSURE(steps == 1003, "zip iterators move backwards");
+
+    sf::VertexArray simd {sf::Triangles, 1003};
+    sf::lerp_positions(sf::zip(a, b, simd), t);
+    blended = true;
+    for (std::size_t i=0; i < 1003; ++i)
+        blended = blended && simd[i].position == out[i].position;
+    ENSURE(blended, "lerp_positions matches the scalar blend");
+
+    sf::lerp_colors(sf::zip(a, b, simd), 0.25f);
+    bool colors = true;
+    for (std::size_t i=0; i < 1003; ++i) {
+        auto const expected = [&](sf::Uint8 ca, sf::Uint8 cb) { return static_cast<sf::Uint8>((ca * 192 + cb * 64 + 128) >> 8); };
+        colors = colors && simd[i].color == sf::Color(
+            expected(a[i].color.r, b[i].color.r), expected(a[i].color.g, b[i].color.g),
+            expected(a[i].color.b, b[i].color.b), expected(a[i].color.a, b[i].color.a));
+    }
+    ENSURE(colors, "lerp_colors blends in 1/256 steps");
+
+    sf::lerp_colors(sf::zip(a, b, simd), 0.f);
+    ENSURE(simd[1002].color == a[1002].color && simd[7].color == a[7].color, "lerp_colors at 0 keeps a");
+    sf::lerp_colors(sf::zip(a, b, simd), 2.f);
+    ENSURE(simd[1002].color == b[1002].color && simd[7].color == b[7].color, "lerp_colors clamps t");
+
+    auto in_place = a;
+    sf::lerp_positions(sf::zip(in_place, b, in_place), t);
+    ENSURE(in_place[1001].position == out[1001].position, "out may be the first keyframe");
+
+    sf::VertexArray empty;
+    sf::lerp_positions(sf::zip(a, b, empty), t);
+    ENSURE(sf::zip(a, empty).empty(), "empty zip");
+}
+
+
+
+void test_triple_buffer()
+{
+    TripleBufferedVertexArray frames {sf::Triangles, 6};
+    ENSURE(!frames.acquire() && frames.front().getVertexCount() == 6, "nothing published yet");
+
+    frames.back()[1].position = {1.f, 1.f};
+    frames.mark_dirty(1, 2);
+    (*(frames.tracking_begin() + 4)).edit().position = {4.f, 4.f};
+    frames.publish();
+    ENSURE(frames.acquire(), "acquire a published frame");
+    ENSURE(frames.front()[1].position == sf::Vector2f(1.f, 1.f) && frames.front()[4].position == sf::Vector2f(4.f, 4.f),
+        "the reader sees the writes");
+    ENSURE(!frames.acquire(), "a frame is acquired once");
+    ENSURE(frames.back()[1].position == sf::Vector2f(1.f, 1.f) && frames.back()[4].position == sf::Vector2f(4.f, 4.f),
+        "the new back buffer is brought up to date");
+
+    frames.back()[2].position = {2.f, 2.f};
+    frames.mark_dirty(frames.write_begin() + 2, frames.write_begin() + 3);
+    frames.publish();
+    frames.back()[3].position = {3.f, 3.f};
+    frames.mark_dirty(3, 4);
+    frames.publish();
+    ENSURE(frames.acquire(), "acquire the latest of two frames");
+    ENSURE(frames.front()[2].position == sf::Vector2f(2.f, 2.f) && frames.front()[3].position == sf::Vector2f(3.f, 3.f)
+        && frames.front()[1].position == sf::Vector2f(1.f, 1.f), "skipped frames are folded in the latest one");
+    ENSURE(std::equal(frames.read_begin(), frames.read_end(), frames.write_begin(), [](auto const& a, auto const& b) {
+        return a.position == b.position;
+    }), "writer and reader agree after the handoff");
+
+    frames.back().append(sf::Vertex{{7.f, 7.f}});
+    frames.publish();
+    frames.acquire();
+    ENSURE(frames.front().getVertexCount() == 7 && frames.back().getVertexCount() == 7
+        && frames.back()[6].position == sf::Vector2f(7.f, 7.f), "resizes are copied whole");
+
+    frames.back()[6].position = {6.f, 6.f};
+    frames.mark_dirty(10, 20);
+    frames.mark_dirty(6, 100);
+    frames.publish();
+    frames.acquire();
+    ENSURE(frames.front()[6].position == sf::Vector2f(6.f, 6.f) && frames.back()[6].position == sf::Vector2f(6.f, 6.f),
+        "dirty ranges are clamped to the vertex count");
+
+    // the reader keeps a frame while the writer publishes more than the history
+    for (std::size_t frame=0; frame < TripleBufferedVertexArray::history_size + 2; ++frame) {
+        frames.back()[frame % 7].position.x += 1.f;
+        frames.mark_dirty(frame % 7, frame % 7 + 1);
+        frames.publish();
+    }
+    frames.acquire();
+    frames.publish();
+    ENSURE(std::equal(frames.read_begin(), frames.read_end(), frames.write_begin(), [](auto const& a, auto const& b) {
+        return a.position == b.position;
+    }), "a buffer behind by more than the history is copied whole");
+
+    // the writer stamps each frame in the last vertex and writes a moving run of
+    // 64 vertices; the reader replays the frames it skipped and compares
+    constexpr std::size_t size = 1024;
+    constexpr int last_frame = 3000;
+    TripleBufferedVertexArray shared {sf::Points, size};
+    auto const write_frame = [](auto&& vertex_at, int frame) {
+        auto const first = static_cast<std::size_t>(frame * 37) % (size - 65);
+        for (std::size_t i=first; i < first + 64; ++i)
+            vertex_at(i).position = {static_cast<float>(frame), static_cast<float>(i)};
+        vertex_at(size - 1).texCoords.x = static_cast<float>(frame);
+        return first;
+    };
+
+    std::thread writer {[&] {
+        for (int frame=1; frame <= last_frame; ++frame) {
+            if (frame % 2) {
+                auto const it = shared.tracking_begin();
+                write_frame([&](std::size_t i) -> sf::Vertex& { return it[static_cast<std::ptrdiff_t>(i)].edit(); }, frame);
+            }
+            else {
+                auto const first = write_frame([&](std::size_t i) -> sf::Vertex& { return shared.back()[i]; }, frame);
+                shared.mark_dirty(first, first + 64);
+                shared.mark_dirty(size - 1, size);
+            }
+            shared.publish();
+        }
+    }};
+
+    sf::VertexArray model {sf::Points, size};
+    int seen = 0;
+    int frames_read = 0;
+    bool consistent = true;
+    bool monotonic = true;
+    while (seen < last_frame) {
+        if (!shared.acquire())
+            continue;
+        auto const frame = static_cast<int>(shared.front()[size - 1].texCoords.x);
+        monotonic = monotonic && frame > seen;
+        for (; seen < frame; )
+            write_frame([&](std::size_t i) -> sf::Vertex& { return model[i]; }, ++seen);
+        consistent = consistent && std::equal(shared.read_begin(), shared.read_end(), sf::cbegin(model),
+            [](auto const& a, auto const& b) { return a.position == b.position; });
+        ++frames_read;
+    }
+    writer.join();
+    ENSURE(monotonic && frames_read > 0, "the reader gets newer frames only");
+    ENSURE(consistent, "every acquired frame is complete, with the dirty ranges copied forward");
+}
+
+
+
+
+void test_indexed()
+{
+    // 10x10 grid of quads sharing their corners, over a repeated texture
+    sf::VertexArray va {sf::Quads};
+    for (int y=0; y < 10; ++y)
+        for (int x=0; x < 10; ++x)
+            for (auto [dx, dy] : {std::pair{0, 0}, {1, 0}, {1, 1}, {0, 1}}) {
+                sf::Vertex vertex;
+                vertex.position = {static_cast<float>(x + dx) * 16.f, static_cast<float>(y + dy) * 16.f};
+                vertex.texCoords = vertex.position;
+                va.append(vertex);
+            }
+
+    IndexedVertexArray<std::uint16_t> indexed;
+    ENSURE(indexed.encode(va), "grid is encoded");
+    ENSURE(indexed.getVertexCount() == 400 && indexed.getPrimitiveType() == sf::Quads, "size and type are kept");
+    ENSURE(indexed.unique_count() == 121, "shared corners are stored once");
+    ENSURE(indexed.memory_size() == 121 * sizeof(sf::Vertex) + 400 * 2, "unique vertices plus 16-bit indices");
+
+    ENSURE(std::distance(indexed.begin(), indexed.end()) == 400, "iterators span the expanded vertices");
+    ENSURE(std::equal(indexed.cbegin(), indexed.cend(), sf::cbegin(va),
+        [](sf::Vertex const& a, sf::Vertex const& b) {
+            return a.position == b.position && a.color == b.color && a.texCoords == b.texCoords;
+        }), "iteration expands the indices");
+
+    auto it = indexed.end() - 1;
+    ENSURE(it->position == va[399].position, "last vertex");
+    ENSURE(it[-395].position == va[4].position && (indexed.begin() + 4)->position == va[4].position, "random access");
+    ENSURE(indexed.begin() < it && it - indexed.begin() == 399, "iterator ordering and distance");
+    ENSURE(&indexed[1] == &indexed[4], "corner shared by two quads is one vertex");
+
+    sf::Transform move;
+    move.translate(5.f, -3.f);
+    sf::apply_transform(indexed.data(), indexed.data() + indexed.unique_count(), move);
+    sf::apply_transform(va, move);
+
+    sf::VertexArray decoded;
+    indexed.decode(decoded);
+    ENSURE(decoded.getVertexCount() == 400 && decoded.getPrimitiveType() == sf::Quads, "decode restores size and type");
+    auto same = true;
+    for (std::size_t i=0; i < va.getVertexCount(); ++i)
+        same = same && decoded[i].position == va[i].position && decoded[i].texCoords == va[i].texCoords;
+    ENSURE(same, "transforming the unique vertices transforms every expanded vertex");
+
+    sf::VertexArray points {sf::Points, 70'000};
+    for (std::size_t i=0; i < points.getVertexCount(); ++i)
+        points[i].position = {static_cast<float>(i), 0.f};
+    ENSURE(!indexed.encode(points), "too many distinct vertices for 16-bit indices");
+    ENSURE(indexed.empty() && indexed.unique_count() == 0, "failed encode leaves the array empty");
+
+    IndexedVertexArray<> wide;
+    ENSURE(wide.encode(points) && wide.unique_count() == 70'000, "32-bit indices address every vertex");
+}
+
+
+
+
+void test_slot_pool()
+{
+    VertexSlotPool pool {sf::Quads, 4};
+    ENSURE(pool.empty() && !pool.valid(VertexSlot_handle{}), "new pool is empty, null handle is invalid");
+
+    // slot i holds 4 vertices at x == i
+    std::vector<VertexSlot_handle> handles;
+    for (int i=0; i < 5; ++i) {
+        handles.push_back(pool.spawn());
+        sf::Vertex* quad = pool.get(handles.back());
+        for (int v=0; v < 4; ++v)
+            quad[v].position.x = static_cast<float>(i);
+    }
+    ENSURE(pool.size() == 5 && pool.array().getVertexCount() == 20, "5 slots of 4 vertices");
+    ENSURE(pool.array().getPrimitiveType() == sf::Quads, "primitive type is kept");
+
+    ENSURE(pool.kill(handles[1]), "kill a live slot");
+    ENSURE(!pool.valid(handles[1]) && pool.get(handles[1]) == nullptr, "killed handle is stale");
+    ENSURE(!pool.kill(handles[1]), "a slot is killed once");
+    ENSURE(pool.size() == 4 && std::distance(sf::begin(pool), sf::end(pool)) == 16, "iteration covers live slots only");
+    ENSURE(pool.get(handles[4]) == sf::contiguous_begin(pool.array()) + 4, "last slot moved into the hole");
+    ENSURE(pool.get(handles[4])[3].position.x == 4.f && pool.get(handles[2])->position.x == 2.f,
+        "handles follow their vertices");
+    ENSURE(pool.handle(1) == handles[4], "slot to handle mapping follows the move");
+
+    auto const reused = pool.spawn();
+    ENSURE(reused.index == handles[1].index && reused != handles[1], "index is reused with a new generation");
+    ENSURE(!pool.valid(handles[1]) && pool.valid(reused), "old handle stays stale after reuse");
+    ENSURE(pool.get(reused) == sf::contiguous_begin(pool.array()) + 16, "new slots are appended");
+
+    ENSURE(pool.kill(handles[2]) && pool.kill(reused), "kill the last slot and a middle slot");
+    auto live = true;
+    for (std::size_t slot=0; slot < pool.size(); ++slot) {
+        auto const handle = pool.handle(slot);
+        live = live && pool.get(handle) == sf::contiguous_begin(pool.array()) + slot * 4;
+    }
+    ENSURE(live, "every live slot is owned by a valid handle");
+    auto const sum = std::accumulate(pool.cbegin(), pool.cend(), 0.f,
+        [](float acc, sf::Vertex const& vertex) { return acc + vertex.position.x; });
+    ENSURE(sum == 4.f * (0.f + 3.f + 4.f), "live vertices are the survivors");
+
+    pool.clear();
+    ENSURE(pool.empty() && pool.array().getVertexCount() == 0, "clear kills every slot");
+    ENSURE(!pool.valid(handles[0]) && !pool.valid(handles[3]), "clear invalidates every handle");
+
+    // random churn against a model
+    std::mt19937 rng {11};
+    std::vector<std::pair<VertexSlot_handle, float>> alive;
+    pool.reserve(1000);
+    auto consistent = true;
+    for (int step=0; step < 20'000; ++step) {
+        if (alive.empty() || rng() % 3 != 0) {
+            auto const handle = pool.spawn();
+            auto const tag = static_cast<float>(step);
+            for (std::size_t v=0; v < 4; ++v)
+                pool.get(handle)[v].position.y = tag;
+            alive.emplace_back(handle, tag);
+        }
+        else {
+            auto const victim = rng() % alive.size();
+            consistent = consistent && pool.kill(alive[victim].first);
+            alive[victim] = alive.back();
+            alive.pop_back();
+        }
+    }
+    for (auto const& [handle, tag] : alive)
+        consistent = consistent && pool.get(handle) != nullptr && pool.get(handle)[3].position.y == tag;
+    ENSURE(consistent && pool.size() == alive.size(), "handles survive random spawns and kills");
+}
+
+
+
+
+void test_generator()
+{
+#if __cplusplus > 201703L
+    auto resumed = 0;
+    auto const counting = [&](int count) -> VertexGenerator {
+        for (int i=0; i < count; ++i) {
+            ++resumed;
+            co_yield sf::Vertex{{static_cast<float>(i), 0.f}};
+        }
+    };
+
+    auto lazy = counting(5);
+    ENSURE(resumed == 0, "nothing is generated before iteration");
+    auto it = lazy.begin();
+    ENSURE(resumed == 1 && it->position.x == 0.f, "begin() runs up to the first vertex");
+    ENSURE(lazy.size_hint() == 0, "no size hint given");
+    auto sum = 0.f;
+    for (; it != lazy.end(); ++it)
+        sum += it->position.x;
+    ENSURE(sum == 10.f && resumed == 5, "iteration yields every vertex once");
+
+    sf::VertexArray va {sf::Points, 2};
+    ENSURE(sf::append(va, counting(100)) == 100 && va.getVertexCount() == 102, "sink grows past a missing hint");
+    ENSURE(va[1].position.x == 0.f && va[2].position.x == 0.f && va[101].position.x == 99.f,
+        "generated vertices follow the existing ones");
+
+    sf::VertexArray large {sf::Points, 100'000};
+    large[99'999].position.x = -1.f;
+    ENSURE(sf::append(large, counting(200)) == 200 && large.getVertexCount() == 100'200
+        && large[99'999].position.x == -1.f && large[100'199].position.x == 199.f,
+        "growth past the hint of a long array keeps its vertices");
+
+    sf::VertexArray circle {sf::Triangles};
+    ENSURE(sf::append(circle, sf::generate_circle({10.f, 20.f}, 5.f, 32, sf::Color::Red)) == 96, "3 vertices per segment");
+    auto on_circle = true;
+    for (std::size_t i=0; i < circle.getVertexCount(); ++i) {
+        auto const d = circle[i].position - sf::Vector2f{10.f, 20.f};
+        auto const distance = std::hypot(d.x, d.y);
+        on_circle = on_circle && (i % 3 == 0 ? distance == 0.f : std::abs(distance - 5.f) < 1e-4f);
+        on_circle = on_circle && circle[i].color == sf::Color::Red;
+    }
+    ENSURE(on_circle, "disc triangles join the center to the rim");
+
+    sf::VertexArray rect {sf::Triangles};
+    sf::append(rect, sf::generate_rounded_rect({0.f, 0.f, 100.f, 40.f}, 10.f, 4));
+    auto const bounds = rect.getBounds();
+    ENSURE(rect.getVertexCount() == 4 * 5 * 3, "one triangle per perimeter point");
+    ENSURE(std::abs(bounds.left) < 1e-4f && std::abs(bounds.top) < 1e-4f
+        && std::abs(bounds.width - 100.f) < 1e-4f && std::abs(bounds.height - 40.f) < 1e-4f,
+        "rounded rectangle fills its rectangle");
+
+    sf::VertexArray stroke {sf::Triangles};
+    auto const count = sf::append(stroke, sf::generate_bezier_stroke({0.f, 0.f}, {100.f, 0.f}, {200.f, 0.f}, {300.f, 0.f}, 4.f, 30));
+    ENSURE(count == 180, "2 triangles per segment");
+    ENSURE(stroke[0].position == (sf::Vector2f{0.f, 2.f}) && stroke[1].position == (sf::Vector2f{0.f, -2.f}),
+        "stroke is offset by half its width along the normal");
+
+    sf::VertexArray culled {sf::Triangles};
+    auto const kept = sf::append(culled,
+        sf::generate_bezier_stroke({0.f, 0.f}, {100.f, 0.f}, {200.f, 0.f}, {300.f, 0.f}, 4.f, 30),
+        [](sf::Vertex const& vertex) { return vertex.position.x < 150.f; });
+    ENSURE(kept % 3 == 0 && kept > 0 && kept < 180, "predicate stops the generator on whole triangles");
+    ENSURE(culled.getVertexCount() == kept && culled.getBounds().width < 150.f, "only visible vertices are kept");
+
+    auto const throwing = []() -> VertexGenerator {
+        co_yield VertexGenerator::Size_hint{10};
+        co_yield sf::Vertex{};
+        throw std::runtime_error {"tessellation failed"};
+    };
+    sf::VertexArray partial {sf::Points, 3};
+    auto rethrown = false;
+    try {
+        sf::append(partial, throwing());
+    }
+    catch (std::runtime_error const&) {
+        rethrown = true;
+    }
+    ENSURE(rethrown && partial.getVertexCount() == 3, "exceptions reach the caller and leave the array unchanged");
+#endif
+}
+
+
+
+
+void test_rasterizer()
+{
+    SoftwareRasterizer target {64, 48};
+
+    // quads of odd sizes tiling the target: every pixel covered exactly once
+    sf::VertexArray tiles {sf::Quads};
+    for (float y=0.f; y < 48.f; y += 12.f)
+        for (float x=0.f; x < 64.f; x += 6.4f)
+            for (auto [dx, dy] : {std::pair{0.f, 0.f}, {6.4f, 0.f}, {6.4f, 12.f}, {0.f, 12.f}})
+                tiles.append(sf::Vertex{{x + dx, y + dy}});
+    target.draw(tiles);
+    auto once = true;
+    for (unsigned y=0; y < 48; ++y)
+        for (unsigned x=0; x < 64; ++x)
+            once = once && target.coverage(x, y) == 1;
+    ENSURE(once, "shared edges are covered once");
+    ENSURE(target.stats().fragments == 64 * 48, "one fragment per pixel");
+    ENSURE(target.stats().triangles == 2 * tiles.getVertexCount() / 4 && target.stats().culled == 0,
+        "two triangles per quad");
+    ENSURE(target.stats().vertices == tiles.getVertexCount(), "every vertex is read");
+
+    target.clear();
+    ENSURE(target.stats().fragments == 0 && target.coverage(10, 10) == 0, "clear resets coverage and stats");
+
+    sf::VertexArray triangles {sf::Triangles};
+    triangles.append(sf::Vertex{{0.f, 0.f}});
+    triangles.append(sf::Vertex{{0.f, 10.f}});
+    triangles.append(sf::Vertex{{10.f, 0.f}});          // either winding
+    triangles.append(sf::Vertex{{5.f, 5.f}});
+    triangles.append(sf::Vertex{{6.f, 6.f}});
+    triangles.append(sf::Vertex{{7.f, 7.f}});           // degenerate
+    triangles.append(sf::Vertex{{100.f, 0.f}});
+    triangles.append(sf::Vertex{{110.f, 0.f}});
+    triangles.append(sf::Vertex{{100.f, 10.f}});        // off the target
+    triangles.append(sf::Vertex{{60.f, 0.f}});
+    triangles.append(sf::Vertex{{70.f, 0.f}});
+    triangles.append(sf::Vertex{{60.f, 10.f}});         // clipped
+    target.draw(triangles);
+    ENSURE(target.stats().triangles == 4 && target.stats().culled == 2, "degenerate and off-target triangles are culled");
+    // centers on the diagonals belong to the other half of each square
+    ENSURE(target.stats().fragments == 45 + (9 + 8 + 7 + 6), "coverage of half squares, one clipped at the right edge");
+    ENSURE(target.coverage(0, 0) == 1 && target.coverage(8, 0) == 1 && target.coverage(9, 0) == 0, "pixel centers decide");
+
+    target.clear();
+    sf::VertexArray strip {sf::TriangleStrip};
+    for (auto position : {sf::Vector2f{0.f, 0.f}, {0.f, 8.f}, {8.f, 0.f}, {8.f, 8.f}, {16.f, 0.f}})
+        strip.append(sf::Vertex{position});
+    target.draw(strip);
+    auto square = true;
+    for (unsigned y=0; y < 8; ++y)
+        for (unsigned x=0; x < 8; ++x)
+            square = square && target.coverage(x, y) == 1;
+    ENSURE(target.stats().triangles == 3 && square, "strip triangles share their edges");
+    ENSURE(target.stats().fragments == 64 + 28, "a square and a half square");
+
+    target.clear();
+    sf::VertexArray fan {sf::TriangleFan};
+    for (auto position : {sf::Vector2f{8.f, 8.f}, {0.f, 0.f}, {16.f, 0.f}, {16.f, 16.f}, {0.f, 16.f}, {0.f, 0.f}})
+        fan.append(sf::Vertex{position});
+    target.draw(fan);
+    ENSURE(target.stats().triangles == 4 && target.stats().fragments == 256, "fan covers its square once");
+
+    target.clear();
+    sf::VertexArray points {sf::Points};
+    for (auto position : {sf::Vector2f{3.7f, 2.2f}, {3.1f, 2.9f}, {-1.f, 0.f}, {64.f, 0.f}})
+        points.append(sf::Vertex{position});
+    target.draw(points);
+    ENSURE(target.stats().fragments == 2 && target.coverage(3, 2) == 2, "points cover the pixel they fall in");
+
+    SoftwareRasterizer empty {0, 0};
+    sf::VertexArray one {sf::Triangles, 3};
+    one[1].position = {10.f, 0.f};
+    one[2].position = {0.f, 10.f};
+    empty.draw(one);
+    ENSURE(empty.stats().triangles == 1 && empty.stats().culled == 1 && empty.stats().fragments == 0,
+        "an empty target culls every triangle");
+
+    // mesh of jittered (still convex) cells past the target, split along random diagonals
+    std::mt19937 rng {5};
+    std::uniform_real_distribution<float> jitter {-1.4f, 1.4f};
+    sf::Vector2f corners[12][15];
+    for (int y=0; y < 12; ++y)
+        for (int x=0; x < 15; ++x)
+            corners[y][x] = {x * 6.f - 12.f + jitter(rng), y * 6.f - 12.f + jitter(rng)};
+    sf::VertexArray mesh {sf::Triangles};
+    for (int y=0; y < 11; ++y)
+        for (int x=0; x < 14; ++x) {
+            auto const p = corners[y][x], q = corners[y][x+1], r = corners[y+1][x+1], t = corners[y+1][x];
+            sf::Vector2f const splits[2][6] = {{p, q, r, p, r, t}, {p, q, t, q, r, t}};
+            for (auto position : splits[rng() % 2])
+                mesh.append(sf::Vertex{position});
+        }
+    target.clear();
+    target.draw(mesh);
+    auto exact = true;
+    for (unsigned y=0; y < 48; ++y)
+        for (unsigned x=0; x < 64; ++x)
+            exact = exact && target.coverage(x, y) == 1;
+    ENSURE(exact, "a mesh with fractional coordinates covers every pixel once");
+}
+
+
+
+#ifdef SF_VA_ITERATOR_CHECKED
+// Whether `operation` aborts through the default check handler, run in a child process
+template <typename Operation>
+bool aborts(Operation&& operation)
+{
+    auto const pid = fork();
+    if (pid == 0) {
+        std::cerr.rdbuf(nullptr);
+        vertex_array::impl::iterator_check_handler = vertex_array::impl::abort_on_iterator_check;
+        operation();
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT;
+}
+
+
+
+
+void test_checked_iterators()
+{
+    sf::VertexArray va {sf::Points, 4};
+    sf::VertexArray other {sf::Points, 4};
+
+    last_check_failure = nullptr;
+    for (auto& v : va)
+        v.position.x += 1.f;
+    std::sort(sf::begin(va), sf::end(va),
+        [](sf::Vertex const& a, sf::Vertex const& b) { return a.position.y < b.position.y; });
+    ENSURE(last_check_failure == nullptr, "valid traversals pass every check");
+
+    ENSURE(aborts([&]{ (void)*sf::end(va); }), "dereferencing end aborts");
+    ENSURE(aborts([&]{ (void)sf::rend(va)->position; }), "dereferencing rend aborts");
+    ENSURE(aborts([&]{ auto it = sf::begin(va); --it; }), "decrementing begin aborts");
+    ENSURE(aborts([&]{ (void)(sf::begin(va) + 5); }), "moving past end aborts");
+    ENSURE(aborts([&]{ (void)(sf::begin(va) < sf::end(other)); }), "comparing iterators of two arrays aborts");
+    ENSURE(aborts([&]{ (void)(sf::end(va) - sf::begin(other)); }), "subtracting iterators of two arrays aborts");
+    ENSURE(aborts([&]{ (void)*VertexArray_iterator{}; }), "dereferencing a singular iterator aborts");
+
+    ENSURE(aborts([&]{
+        auto it = sf::begin(va);
+        for (int i=0; i < 1000; ++i)
+            va.append(sf::Vertex{});
+        (void)*it;
+    }), "an iterator is invalidated by a reallocation");
+}
+#endif
+
+
+
+
+#ifdef SF_VA_ITERATOR_PROFILE
+void test_profile()
+{
+    using namespace vertex_array;
+    auto const find = [](std::vector<profile::Stats> const& stats, std::string const& site) {
+        return std::find_if(stats.begin(), stats.end(), [&](auto const& row) { return row.site == site; });
+    };
+
+    sf::VertexArray va {sf::Points, 10};
+    profile::reset();
+    {
+        SF_VA_PROFILE_SCOPE("walk");
+        for (auto& vertex : va)
+            vertex.position.x += 1.f;
+
+        auto it = sf::begin(va);
+        it += 5;
+        it -= 2;
+        auto const& vertex = it[4];
+        (void)vertex;
+        (void)it->position;     // not a dereference: std::to_address() calls it too
+    }
+    std::thread{[&] {
+        SF_VA_PROFILE_SCOPE("worker");
+        std::for_each(sf::rbegin(va), sf::rend(va), [](sf::Vertex const&) {});
+    }}.join();
+    for (auto it = sf::cbegin(va); it != sf::cend(va); ++it)
+        (void)(*it).position;
+
+    auto const stats = profile::snapshot();
+    auto const walk = find(stats, "walk");
+    ENSURE(walk != stats.end(), "scoped site is recorded");
+    ENSURE(walk->traversals == 2 && walk->steps == 10, "range-based for loop: one traversal, one step per vertex");
+    ENSURE(walk->dereferences == 11, "dereferences, including it[n]");
+    ENSURE(walk->jumps == 3 && walk->jump_distance == 11, "random jumps and their distance");
+
+    auto const worker = find(stats, "worker");
+    ENSURE(worker != stats.end() && worker->thread != walk->thread, "threads keep separate counters");
+    ENSURE(worker->dereferences == 10 && worker->traversals == 1, "reverse iterators are counted");
+
+    auto const unscoped = find(stats, "(unscoped)");
+    ENSURE(unscoped != stats.end() && unscoped->dereferences == 10, "operations outside scopes are unscoped");
+    ENSURE(stats.front().dereferences >= stats.back().dereferences, "sites sorted by dereferences");
+
+    std::ostringstream json, trace;
+    profile::write_json(json);
+    profile::write_chrome_trace(trace);
+    ENSURE(json.str().find("\"site\": \"walk\"") != std::string::npos, "JSON dump");
+    ENSURE(trace.str().find("{\"name\": \"worker\", \"ph\": \"C\"") != std::string::npos, "Chrome trace counter events");
+
+    profile::reset();
+    ENSURE(profile::snapshot().empty(), "reset");
+
+    // a thread running across a reset zeroes its own counters on its next operation
+    std::atomic<int> phase {0};
+    std::thread running {[&] {
+        SF_VA_PROFILE_SCOPE("running");
+        std::for_each(sf::cbegin(va), sf::cend(va), [](sf::Vertex const&) {});
+        phase = 1;
+        while (phase != 2) std::this_thread::yield();
+        auto const first = sf::cbegin(va);
+        std::for_each(first, first + 3, [](sf::Vertex const&) {});
+    }};
+    while (phase != 1) std::this_thread::yield();
+    profile::reset();
+    auto const hidden = profile::snapshot();
+    ENSURE(find(hidden, "running") == hidden.end(), "a reset hides the counters of running threads");
+    phase = 2;
+    running.join();
+    auto const after = profile::snapshot();
+    auto const resumed = find(after, "running");
+    ENSURE(resumed != after.end() && resumed->dereferences == 3 && resumed->traversals == 1,
+        "counting resumes from zero after a reset");
+}
+#endif